@@ -103,6 +103,10 @@ void MDNS::addTXTEntry(String key, String value) {
   txtRecord->addEntry(key, value);
 }
 
+void MDNS::setTXTEntry(String key, String value) {
+  txtRecord->setEntry(key, value);
+}
+
 bool MDNS::begin() {
   // Wait for WiFi to connect
   while (!WiFi.ready()) {
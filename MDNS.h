@@ -23,6 +23,8 @@ public:
 
   void addTXTEntry(String key, String value = NULL);
 
+  void setTXTEntry(String key, String value);
+
   bool begin();
 
   bool processQueries();
@@ -134,6 +134,19 @@ void TXTRecord::addEntry(String key, String value) {
   data.push_back(entry);
 }
 
+void TXTRecord::setEntry(String key, String value) {
+  String prefix = key + '=';
+
+  for (std::vector<String>::iterator i = data.begin(); i != data.end(); ++i) {
+    if (i->startsWith(prefix)) {
+      *i = prefix + value;
+      return;
+    }
+  }
+
+  addEntry(key, value);
+}
+
 void TXTRecord::writeSpecific(Buffer * buffer) {
   uint16_t size = 0;
 
@@ -142,6 +142,8 @@ public:
 
   void addEntry(String key, String value = NULL);
 
+  void setEntry(String key, String value);
+
 private:
 
   std::vector<String> data;
@@ -30,7 +30,9 @@ void COM::initialize_mdns(){
 
   if (mdns_success) {
     log("Host Name Set Successfully");
-    mdns_success = mdns.addService("tcp", "beem", BEEMO_PORT, "frisbeem", subServices);
+    //Session First, The TXT Entries Below Land On The Last Service Added
+    mdns_success = mdns.addService("udp", "beemsession", SESSION_PORT, "frisbeem");
+    mdns_success = mdns_success && mdns.addService("tcp", "beem", BEEMO_PORT, "frisbeem", subServices);
   }
 
   mdns.addTXTEntry("frsibeem");
@@ -57,11 +59,19 @@ void COM::tick(){
 }
 
 void COM::update(){
+  if ( wifiOff ) return;
+  if ( restartPending ){
+    if ( !WiFi.ready() ) return;
+    restartPending = false;
+    initialize_server();
+    mdns.begin();
+    frisbeem.joinSession(); //Socket Went Down With The Radio
+  }
   log("Sending MDNS Information");
+  if ( mdns_success && millis() - _lastTxt >= txtInterval ){ update_txt_metrics(); }
   mdns.processQueries();
   lastMsg = read();
   parseStringForMessage(lastMsg);
-  send_telemetry();
 }
 
 void COM::open(){
@@ -140,20 +150,119 @@ void COM::parseStringForMessage(String inputString){
 
 void COM::handleCommand(String pk, String sk, String arg)
 {
+  frisbeem._power.noteClient();
   if (pk.equals("PWR")){
     if (sk.equals("OFF")){ frisbeem._lights._on = false;}
     if (sk.equals("ONN")){ frisbeem._lights._on = true;}
+    if (sk.equals("STA")){ send_power(); }
+    if (sk.equals("MOD")){ frisbeem._power.transitionTo( arg.toInt() ); } //See PowerSwitch::PowerModes
+  }
+  if (pk.equals("POV")){
+    if (sk.equals("ONN")){ frisbeem._pov.enabled = true; }
+    if (sk.equals("OFF")){ frisbeem._pov.enabled = false; }
+    if (sk.equals("IMG")){ frisbeem.loadPovImage( arg.toInt() ); }
+    if (sk.equals("STA")){ //Enabled, Running, Column, Columns Latched, Timer Ticks, Push Micros, Frames Pushed
+      telemetry("POV",  String(frisbeem._pov.enabled)+","+String(frisbeem._pov.running())+","+
+                        String(frisbeem._pov.latchedColumn)+","+String(frisbeem._pov.latches)+","+String(frisbeem._pov.polls)+","+
+                        String(frisbeem._pov.pushMicros)+","+String(frisbeem._pov.frames)+";");
+    }
+  }
+  if (pk.equals("LED")){
+    if (sk.equals("STA")){ telemetry("LED", String(frisbeem._lights.framesDrawn)+","+String(frisbeem._lights.framesSkipped)+";"); }
+    if (sk.equals("RST")){ frisbeem._lights.framesDrawn = 0; frisbeem._lights.framesSkipped = 0; }
   }
   if (pk.equals("TEL")){
-    if (sk.equals("CAL"))
-    {
-      // Calibrate gyro and accelerometers, load biases in bias registers
-      frisbeem._mpu.calibrateMPU9250(frisbeem._mpu.gyroBias, frisbeem._mpu.accelBias);
-      delay(1000);
-      frisbeem._mpu.initMPU9250();
-      frisbeem._mpu.Axy_lp = 0;
-      frisbeem._mpu.Axy_lp = 0;
-     }
+    if (sk.equals("CAL")){ frisbeem.calibrate(); }
+  }
+  if (pk.equals("FUS")){
+    //ACC & MAG Take <profile>,<hz>, Profiles Follow The MotionSwitch States
+    int comma = arg.indexOf(',');
+    int profile = arg.substring(0, comma).toInt();
+    if ( comma > 0 && profile >= 0 && profile < FUSION_PROFILES ){
+      MPU_9250::FusionRates &rates = frisbeem._mpu.fusionRates[ profile ];
+      if (sk.equals("ACC")){ rates.accelHz = arg.substring(comma + 1).toFloat(); }
+      if (sk.equals("MAG")){ rates.magHz = arg.substring(comma + 1).toFloat(); }
+    }
+    if (sk.equals("RST")){ frisbeem._mpu.resetFusionStats(); }
+    if (sk.equals("STA")){ send_fusion_stats(); }
+  }
+  if (pk.equals("GST")){
+    if (sk.equals("ONN")){ frisbeem._gestures.enabled = true; }
+    if (sk.equals("OFF")){ frisbeem._gestures.enabled = false; }
+    if (sk.equals("REC")){ frisbeem._gestures.record( arg.toInt() ); } //Slot, Do The Gesture Right After
+    if (sk.equals("CLR")){ frisbeem._gestures.clear( arg.toInt() ); }
+    if (sk.equals("SAV")){ frisbeem._gestures.save(); }
+    if (sk.equals("DEF")){ frisbeem._gestures.loadDefaults(); }
+    if (sk.equals("ACT")){ //<slot>,<action> See GestureActions, Replies With The Whole Table. SAV Keeps It
+      int comma = arg.indexOf(',');
+      if ( comma > 0 ){ frisbeem._gestures.setAction( arg.substring(0, comma).toInt(), arg.substring(comma + 1).toInt() ); }
+      String table = String(frisbeem._gestures.actions[0]);
+      for (uint8_t i = 1; i < MAX_GESTURES; i++){ table += ","+String(frisbeem._gestures.actions[i]); }
+      telemetry("GSA", table+";");
+    }
+    if (sk.equals("STA")){ send_gesture_stats(); }
+  }
+  if (pk.equals("BUS")){
+    if (sk.equals("BEN")){ //Dispatch Cost, Old Visitor Path vs EventBus, 4 Observers
+      uint32_t visitorMicros, busMicros;
+      uint32_t iterations = arg.toInt() > 0 ? arg.toInt() : 1000;
+      benchmarkEventDispatch( iterations, 4, visitorMicros, busMicros );
+      telemetry("BEN", String(iterations)+","+String(visitorMicros)+","+String(busMicros)+";");
+    }
+  }
+  if (pk.equals("GAM")){
+    if (sk.equals("SET")){ frisbeem._gameMode.switchTo( arg.toInt() ); send_game(); } //Just This One
+    if (sk.equals("ONN")){ frisbeem._gameMode.activate( arg.toInt(), true ); send_game(); }
+    if (sk.equals("OFF")){ //One By Index, Or All
+      if (arg.length() > 0){ frisbeem._gameMode.activate( arg.toInt(), false ); }
+      else { frisbeem._gameMode.switchTo( NO_GAME ); }
+      send_game();
+    }
+    if (sk.equals("STA")){ send_game(); }
+    if (sk.equals("CST")){ send_game_cost(); }
+    if (sk.equals("RST")){ frisbeem._gameMode.resetCosts(); }
+    if (sk.equals("BUD")){ frisbeem._gameMode.frameBudget = arg.toInt(); }
+  }
+  if (pk.equals("SES")){
+    if (sk.equals("STA")){ send_session(); }
+    if (sk.equals("PER")){ send_peers(); }
+  }
+  if (pk.equals("STM")){
+    if (sk.equals("MOT")){ send_state_metrics( frisbeem._motionState, "MOT" ); }
+    if (sk.equals("PWR")){ send_state_metrics( frisbeem._power, "PWR" ); }
+    if (sk.equals("RST")){ frisbeem._motionState.resetMetrics(); frisbeem._power.resetMetrics(); }
+  }
+  if (pk.equals("QUE")){
+    if (sk.equals("STA")){ send_queue_stats(); }
+    if (sk.equals("RST")){ frisbeem._deferred.resetStats(); }
+    if (sk.equals("BUD")){ frisbeem.deferredBudget = arg.toInt(); } //Microseconds
+  }
+  if (pk.equals("LAT")){
+    if (sk.equals("STA")){ send_latency(); }
+    if (sk.equals("RST")){ frisbeem._latency.reset(); }
+  }
+  if (pk.equals("HST")){
+    if (sk.equals("WIN")){ //<channel>,<milliseconds> See MotionChannel
+      int comma = arg.indexOf(',');
+      WindowStats stats;
+      uint8_t channel = arg.substring(0, comma).toInt();
+      unsigned long span = arg.substring(comma + 1).toInt() * 1000UL;
+      //Asked Once, Tracked From Then On. Walk The Buffer Only When Every Window Is Taken
+      int8_t window = frisbeem._history.find( channel, span );
+      if ( window < 0 && comma > 0 ) window = frisbeem._history.track( channel, span );
+      bool found = window >= 0 ? frisbeem._history.windowStats( window, stats ) : frisbeem._history.stats( channel, span, stats );
+      if ( comma > 0 && found ){
+        telemetry("HST", String(channel)+","+String(stats.count)+","+String(stats.min)+","+String(stats.max)+","+String(stats.mean)+";");
+      }
+    }
+  }
+  if (pk.equals("SMT")){
+    if (sk.equals("ONN")){ frisbeem._smoother.reset( frisbeem._mpu.X.z, frisbeem._mpu.V.z ); frisbeem._smoother.enabled = true; }
+    if (sk.equals("OFF")){ frisbeem._smoother.enabled = false; }
+    if (sk.equals("LAG")){ //Milliseconds. Replies With The Lag & How Many Samples The Window Can Hold Of It
+      frisbeem._smoother.lagMicros = arg.toInt() * 1000UL;
+      telemetry("SMT", String(frisbeem._smoother.lagMicros / 1000)+","+String(SMOOTHER_MAX_LAG)+";");
+    }
   }
 }
 
@@ -180,6 +289,11 @@ void COM::log(String message, bool force){
   #endif*/
 }
 
+void COM::log(const char *message, bool force){
+  if ( !writeNow && !force ) return;
+  log( String(message), true );
+}
+
 void COM::telemetry(String pck, String message){
   //Send telemetry every opprotunity only on wifi
   if ( initialConnection ){
@@ -190,11 +304,151 @@ void COM::telemetry(String pck, String message){
 }
 
 void COM::send_telemetry(){
+  if ( frisbeem._mpu.sampleSeq == _sentSeq ) return; //Already Out, Don't Repeat A Frame
+  _sentSeq = frisbeem._mpu.sampleSeq;
+  if ( !frisbeem._motionState.throwing() && ( idleTelemetryDivider == 0 || ++_telemetryCount < idleTelemetryDivider ) ) return;
+  _telemetryCount = 0;
+  send_sequence();
   send_time();
   send_gyro();
   send_acl_rl();
   send_vel();
   send_pos();
+  send_smoothed();
+  if ( initialConnection ){ frisbeem._latency.record( LAT_WIRE, frisbeem._mpu.sampleTime ); }
+}
+
+void COM::send_sequence(){
+  //Raw Sample The Following Frames Came From
+  telemetry("SEQ",  String(frisbeem._mpu.sampleSeq)+","+
+                    String(frisbeem._mpu.sampleTime)+";");
+}
+
+void COM::send_state_metrics(StateSwitch &sw, String tag){
+  uint8_t states = sw.numStates < METRIC_STATES ? sw.numStates : METRIC_STATES;
+  StateMetrics &m = sw.metrics;
+
+  //Residency ms Per State, Then Transitions & Hook Cost
+  String residency = tag;
+  for (uint8_t i = 0; i < states; i++){ residency += ","+String(sw.residency(i)); }
+  telemetry("STR", residency+";");
+  telemetry("STH", tag+","+String(m.count)+","+
+                   String(m.count > 0 ? m.hookMicros / m.count : 0)+","+
+                   String(m.hookMaxMicros)+";");
+
+  //Transition Matrix, One Row Per From State
+  for (uint8_t from = 0; from < states; from++){
+    String row = tag+","+String(from);
+    for (uint8_t to = 0; to < states; to++){ row += ","+String(m.transitions[from][to]); }
+    telemetry("STX", row+";");
+  }
+
+  //Latest First, from>to@millis
+  String recent = tag;
+  StateMetrics::Transition *t;
+  for (uint8_t age = 0; (t = sw.recentTransition(age)) != NULL; age++){
+    recent += ","+String(t -> from)+">"+String(t -> to)+"@"+String(t -> t);
+  }
+  telemetry("STL", recent+";");
+}
+
+void COM::update_txt_metrics(){
+  _lastTxt = millis();
+  MotionSwitch &motion = frisbeem._motionState;
+  String residency;
+  for (uint8_t i = 0; i < motion.numStates && i < METRIC_STATES; i++){
+    if (i > 0) residency += ",";
+    residency += String(motion.residency(i) / 1000); //Seconds, TXT Entries Are Short
+  }
+  mdns.setTXTEntry("phase", String(motion.currentState));
+  mdns.setTXTEntry("res", residency);
+  mdns.setTXTEntry("flips", String(motion.metrics.count));
+  mdns.setTXTEntry("power", String(frisbeem._power.currentState));
+  mdns.setTXTEntry("disc", String(frisbeem._session.disc));
+  mdns.setTXTEntry("peers", String(frisbeem._session.numPeers));
+}
+
+void COM::send_session(){
+  //Disc, Leader, Peers, Clock Offset & Round Trip (us), Sent, Received, Rejected
+  Session &s = frisbeem._session;
+  telemetry("SES",  String(s.disc)+","+String(s.leader())+","+String(s.numPeers)+","+String(s.clockOffset)+","+
+                    String(s.syncRtt)+","+String(s.sent)+","+String(s.received)+","+String(s.rejected)+";");
+}
+
+void COM::send_peers(){
+  //One Line Per Peer: Disc, ms Since Heard, Phase, Power, Score, Spin, Lost Packets
+  Session &s = frisbeem._session;
+  unsigned long now = micros();
+  for (uint8_t i = 0; i < s.numPeers; i++){
+    SessionPeer &p = s.peers[i];
+    telemetry("SPR",  String(p.disc)+","+String((now - p.heard) / 1000)+","+String(p.state.phase)+","+
+                      String(p.state.power)+","+String(p.state.score)+","+String(p.state.spin)+","+String(p.lost)+";");
+  }
+}
+
+void COM::send_game(){
+  //Active Mask, Then Every Game In Index Order
+  String games = String(frisbeem._gameMode.activeMask);
+  for (uint8_t i = 0; i < frisbeem._gameMode.numGames; i++){ games += ","+frisbeem._gameMode.game(i) -> name(); }
+  telemetry("GAM", games+";");
+}
+
+void COM::send_game_cost(){
+  //Three Lines Per Game, update(), Motion & Script Deliveries, Then Impacts & Gestures: Index, Calls, Avg, Max, Budget (us), Overruns, Suspends, Deferred, Rate Divider
+  for (uint8_t i = 0; i < frisbeem._gameMode.numGames; i++){
+    Game *game = frisbeem._gameMode.game(i);
+    GameCost &c = game -> cost;
+    telemetry("GCS",  String(i)+","+String(c.calls)+","+String(c.avgMicros)+","+String(c.maxMicros)+","+
+                      String(game -> updateBudget)+","+String(c.overruns)+","+String(c.suspends)+","+
+                      String(c.deferred)+","+String(c.divider)+";");
+    GameCost &d = game -> deliveryCost;
+    telemetry("GCD",  String(i)+","+String(d.calls)+","+String(d.avgMicros)+","+String(d.maxMicros)+","+
+                      String(game -> deliveryBudget)+","+String(d.overruns)+","+String(d.suspends)+","+
+                      String(d.deferred)+","+String(d.divider)+";");
+    GameCost &e = game -> eventCost;
+    telemetry("GCE",  String(i)+","+String(e.calls)+","+String(e.avgMicros)+","+String(e.maxMicros)+","+
+                      String(game -> deliveryBudget)+","+String(e.overruns)+","+String(e.suspends)+","+
+                      String(e.deferred)+","+String(e.divider)+";");
+  }
+}
+
+void COM::send_power(){
+  //Mode, ms In Mode, ms Since Activity, Wakes From SLEEP By Motion & By Timeout
+  telemetry("PWR",  String(frisbeem._power.currentState)+","+
+                    String(millis() - frisbeem._power.modeSince)+","+
+                    String(millis() - frisbeem._power.lastActivity)+","+
+                    String(frisbeem._power.motionWakes)+","+String(frisbeem._power.timeoutWakes)+";");
+}
+
+void COM::send_queue_stats(){
+  //Priority, Depth, Max Depth, Posted, Run, Dropped, Deadline Misses
+  DeferredQueue &queue = frisbeem._deferred;
+  for (uint8_t p = 0; p < NUM_PRIORITIES; p++){
+    DeferredQueue::Stats &st = queue.stats[p];
+    telemetry("QUE",  String(p)+","+
+                      String(queue.depth(p))+","+
+                      String(st.maxDepth)+","+
+                      String(st.posted)+","+
+                      String(st.run)+","+
+                      String(st.dropped)+","+
+                      String(st.deadlineMisses)+";");
+  }
+  telemetry("QUB",  String(frisbeem.deferredBudget)+","+
+                    String(queue.carriedOver)+","+
+                    String(queue.budgetOverruns)+";");
+}
+
+void COM::send_latency(){
+  //Stage, Count, p50, p99, Max, Last (Microseconds)
+  for (uint8_t i = 0; i < NUM_LATENCY_STAGES; i++){
+    LatencyHistogram &h = frisbeem._latency.stages[i];
+    telemetry("LAT",  String(frisbeem._latency.name(i))+","+
+                      String(h.count)+","+
+                      String(h.percentile(50))+","+
+                      String(h.percentile(99))+","+
+                      String(h.maxMicros)+","+
+                      String(h.lastMicros)+";");
+  }
 }
 
 void COM::send_time(){
@@ -235,3 +489,41 @@ void COM::send_pos(){
                     String(frisbeem._mpu.X.y)+","+
                     String(frisbeem._mpu.X.z)+";");
 }
+
+void COM::send_fusion_stats(){
+  //Calls, Total & Max Microseconds For Each Fusion Step
+  MPU_9250 &mpu = frisbeem._mpu;
+  telemetry("FUS",  String(mpu.fusionProfile())+";"+
+                    String(mpu.propagateStats.calls)+","+String(mpu.propagateStats.totalMicros)+","+String(mpu.propagateStats.maxMicros)+";"+
+                    String(mpu.accelStats.calls)+","+String(mpu.accelStats.totalMicros)+","+String(mpu.accelStats.maxMicros)+";"+
+                    String(mpu.magStats.calls)+","+String(mpu.magStats.totalMicros)+","+String(mpu.magStats.maxMicros)+";");
+}
+
+void COM::send_smoothed(){
+  //Only When The Smoother Produced A Point This Sample
+  if ( frisbeem.smoothedReady ){
+    telemetry("SMZ",  String(frisbeem.smoothedPoint.t)+","+
+                      String(frisbeem.smoothedPoint.z)+","+
+                      String(frisbeem.smoothedPoint.vz)+","+
+                      String(frisbeem._smoother.lookahead / 1000)+","+   //ms, short of the lag when the window ran out
+                      String(frisbeem._smoother.dropped)+";");
+  }
+}
+
+void COM::send_throw(ThrowRecord &record){
+  //One Line Per Throw: Number, Speed, RPM, Hyzer, Time, Peak, Distance
+  telemetry("THR",  String(record.number)+","+
+                    String(record.releaseSpeed)+","+
+                    String(record.releaseRpm)+","+
+                    String(record.hyzer)+","+
+                    String(record.flightTime)+","+
+                    String(record.peakHeight)+","+
+                    String(record.distance)+";");
+}
+
+void COM::send_gesture_stats(){
+  //Steps, Pruned By Lower Bound, DTW Runs, DTW Abandoned, Last Match
+  GestureEngine &g = frisbeem._gestures;
+  telemetry("GST",  String(g.steps)+","+String(g.lbPruned)+","+String(g.dtwRun)+","+String(g.dtwAbandoned)+";"+
+                    String(g.lastGesture)+","+String(g.lastDistance)+";");
+}
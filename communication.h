@@ -1,5 +1,6 @@
 #include "application.h"
 #include "MDNS.h"
+#include "throwmetrics.h"
 #include <vector>
 
 
@@ -7,6 +8,8 @@
 #define BEEMO_PORT 18330
 #define LOG_DEBUG false //5ms log delay
 
+class StateSwitch;
+
 class COM { //, public Subject{
   //In which we send information
   //Obsever so it can recieve notifications
@@ -22,6 +25,15 @@ public:
   int tickCount = 100;
   int _tick = tickCount - 1; //Tick One Less than tickCount will print first time
 
+  //Telemetry Goes Out Every Sample While Throwing, Every idleTelemetryDivider Samples Otherwise (Set By The Power Mode, 0 For None)
+  int idleTelemetryDivider = 10;
+  int _telemetryCount = 0;
+  uint32_t _sentSeq = 0;
+
+  //State Metrics In The mDNS TXT Record, Refreshed Off The Sample Path
+  unsigned long txtInterval = 5000; //ms
+  unsigned long _lastTxt = 0;
+
   //MDNS
   String hostname = "frisbeem";
   String serverMessage = "HTTP/1.1 200 Ok\n\n<html><body><h1>~HELLO BEEMO!~</h1></body></html>\n\n";
@@ -41,9 +53,12 @@ public:
   bool debugMode = true;
   bool writeNow = true; //Tells log to write. True Means First Time will print
   bool initialConnection = false;
+  bool wifiOff = false;        //Radio turned off by the power profile
+  bool restartPending = false; //Bring server & mDNS back once WiFi is ready
 
   //Important Functions
   void log(String message,bool force=false);
+  void log(const char *message,bool force=false); //Literals, nothing is built unless it's going out
   void telemetry(String pck, String message);
   void initialize();
   void update();
@@ -68,6 +83,20 @@ public:
   void send_gyro();
   void send_vel();
   void send_pos();
+  void send_fusion_stats();
+  void send_smoothed();
+  void send_throw(ThrowRecord &record);
+  void send_gesture_stats();
+  void send_sequence();
+  void send_latency();
+  void send_queue_stats();
+  void send_power();
+  void send_game();
+  void send_session();
+  void send_peers();
+  void send_game_cost();
+  void send_state_metrics(StateSwitch &sw, String tag);
+  void update_txt_metrics();
 
   // void serial_sendTelemetry();
   // void com_sendTelemetry();
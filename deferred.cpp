@@ -0,0 +1,76 @@
+#include "deferred.h"
+
+DeferredQueue::DeferredQueue()
+{
+  for (uint8_t p = 0; p < NUM_PRIORITIES; p++){
+    _head[p] = 0;
+    _count[p] = 0;
+  }
+  deadline[PRIORITY_CRITICAL] = 2000;
+  deadline[PRIORITY_GAME] = 20000;
+  deadline[PRIORITY_REPORT] = 100000;
+  resetStats();
+}
+
+void DeferredQueue::resetStats()
+{
+  for (uint8_t p = 0; p < NUM_PRIORITIES; p++){
+    stats[p].posted = 0; stats[p].run = 0; stats[p].dropped = 0;
+    stats[p].deadlineMisses = 0; stats[p].maxDepth = _count[p];
+  }
+  carriedOver = 0;
+  budgetOverruns = 0;
+}
+
+bool DeferredQueue::post(uint8_t priority, Call call, void *target, const void *payload, uint8_t size, bool unique)
+{
+  if ( priority >= NUM_PRIORITIES || size > DEFERRED_PAYLOAD ) return false;
+  if ( unique ){
+    for (uint8_t i = 0; i < _count[priority]; i++){
+      Item &waiting = _items[priority][ (_head[priority] + i) & (DEFERRED_DEPTH - 1) ];
+      if ( waiting.call == call && waiting.target == target ) return false;
+    }
+  }
+  if ( _count[priority] >= DEFERRED_DEPTH ){
+    stats[priority].dropped++;
+    return false;
+  }
+
+  Item &item = _items[priority][ (_head[priority] + _count[priority]) & (DEFERRED_DEPTH - 1) ];
+  item.call = call;
+  item.target = target;
+  item.queued = micros();
+  if ( size > 0 ) memcpy( item.payload, payload, size );
+
+  _count[priority]++;
+  stats[priority].posted++;
+  if ( _count[priority] > stats[priority].maxDepth ) stats[priority].maxDepth = _count[priority];
+  return true;
+}
+
+void DeferredQueue::run(uint8_t priority)
+{ //Pop A Copy First, The Call May Post More Work Into The Slot
+  Item item = _items[priority][ _head[priority] ];
+  _head[priority] = (_head[priority] + 1) & (DEFERRED_DEPTH - 1);
+  _count[priority]--;
+  if ( micros() - item.queued > deadline[priority] ) stats[priority].deadlineMisses++;
+  stats[priority].run++;
+  item.call( item.target, item.payload );
+}
+
+void DeferredQueue::dispatch(unsigned long budgetMicros)
+{
+  unsigned long start = micros();
+  while ( _count[PRIORITY_CRITICAL] > 0 ){ run( PRIORITY_CRITICAL ); }
+
+  for (uint8_t p = PRIORITY_CRITICAL + 1; p < NUM_PRIORITIES; p++){
+    while ( _count[p] > 0 ){
+      if ( micros() - start >= budgetMicros ){
+        carriedOver++;
+        return;
+      }
+      run( p );
+    }
+  }
+  if ( micros() - start > budgetMicros ) budgetOverruns++;
+}
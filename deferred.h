@@ -0,0 +1,58 @@
+#include "application.h"
+
+#ifndef _INCL_DEFERRED
+#define _INCL_DEFERRED
+
+#define DEFERRED_DEPTH 16   //Per Priority, Power Of Two
+#define DEFERRED_PAYLOAD 16 //Bytes Copied In With Each Call
+
+enum DeferredPriority {
+  PRIORITY_CRITICAL = 0, //Always runs in full, budget or not
+  PRIORITY_GAME,
+  PRIORITY_REPORT,       //Telemetry, sounds, anything for the outside world
+  NUM_PRIORITIES
+};
+
+//Prioritized Deferred Work
+//Anything that doesn't have to happen inside the sensor read gets posted here & run from dispatch() after the
+//physics step, highest priority first, until the time budget is spent. What doesn't fit waits for the next iteration.
+class DeferredQueue
+{
+public:
+  typedef void (*Call)(void *target, void *payload);
+
+  DeferredQueue();
+
+  //Copies size bytes of payload in. unique skips the post if the same call is already waiting. False when full or skipped
+  bool post(uint8_t priority, Call call, void *target, const void *payload = NULL, uint8_t size = 0, bool unique = false);
+  void dispatch(unsigned long budgetMicros);
+  void resetStats();
+
+  uint8_t depth(uint8_t priority) { return _count[priority]; };
+
+  struct Stats {
+    uint32_t posted, run, dropped;
+    uint32_t deadlineMisses; //Waited longer than deadline before running
+    uint8_t maxDepth;
+  };
+  Stats stats[NUM_PRIORITIES];
+  unsigned long deadline[NUM_PRIORITIES]; //Micros an item may wait
+  uint32_t carriedOver = 0;    //Dispatches that ran out of budget with work left
+  uint32_t budgetOverruns = 0; //Dispatches that went past budget (one slow item, or critical work)
+
+private:
+  struct Item {
+    Call call;
+    void *target;
+    unsigned long queued;
+    uint8_t payload[DEFERRED_PAYLOAD];
+  };
+
+  Item _items[NUM_PRIORITIES][DEFERRED_DEPTH];
+  uint8_t _head[NUM_PRIORITIES];
+  uint8_t _count[NUM_PRIORITIES];
+
+  void run(uint8_t priority);
+};
+
+#endif
@@ -0,0 +1,59 @@
+#include "detectors.h"
+#import "event.h"
+
+float channelValue(MotionEvent &motion, uint8_t channel)
+{
+  switch (channel)
+  {
+    case CH_GX: return motion.G.x;
+    case CH_GY: return motion.G.y;
+    case CH_GZ: return motion.G.z;
+    case CH_AX: return motion.A.x;
+    case CH_AY: return motion.A.y;
+    case CH_AZ: return motion.A.z;
+    case CH_VX: return motion.V.x;
+    case CH_VY: return motion.V.y;
+    case CH_VZ: return motion.V.z;
+    case CH_XX: return motion.X.x;
+    case CH_XY: return motion.X.y;
+    case CH_XZ: return motion.X.z;
+    case CH_AXY: return sqrt( motion.A.x * motion.A.x + motion.A.y * motion.A.y );
+    case CH_AMAG: return motion.A.getMagnitude();
+    case CH_ALXY: return sqrt( motion.Alin.x * motion.Alin.x + motion.Alin.y * motion.Alin.y );
+  }
+  return 0;
+}
+
+bool ExtremumDetector::update(float value, unsigned long t)
+{
+  //Valleys Are Peaks Upside Down
+  float v = maximum ? value : -value;
+  if ( !_started ){
+    _started = true;
+    _extreme = v;
+    _extremeTime = t;
+    return false;
+  }
+  if ( _seeking ){
+    if ( v >= _extreme ){
+      _extreme = v;
+      _extremeTime = t;
+    }
+    else if ( v < _extreme - hysteresis ){
+      detectedValue = maximum ? _extreme : -_extreme;
+      detectedTime = _extremeTime;
+      _seeking = false;
+      _extreme = v; //Now Track The Way Back
+      return true;
+    }
+  }
+  else{
+    if ( v < _extreme ){ _extreme = v; }
+    else if ( v > _extreme + hysteresis ){
+      _seeking = true;
+      _extreme = v;
+      _extremeTime = t;
+    }
+  }
+  return false;
+}
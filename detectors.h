@@ -0,0 +1,60 @@
+#include "application.h"
+
+#ifndef _INCL_DETECTORS
+#define _INCL_DETECTORS
+
+class MotionEvent;
+
+//Scalar Channels Of A MotionEvent A Detector Can Watch
+enum MotionChannel {
+  CH_GX = 0, CH_GY, CH_GZ,
+  CH_AX, CH_AY, CH_AZ,
+  CH_VX, CH_VY, CH_VZ,
+  CH_XX, CH_XY, CH_XZ,
+  CH_AXY, CH_AMAG, //Derived: horizontal & total acceleration magnitude
+  CH_ALXY,         //Derived: in-plane linear acceleration, what the MPU's rest flag thresholds
+  CH_COUNT
+};
+
+float channelValue(MotionEvent &motion, uint8_t channel);
+
+//Incremental Detector Over One Scalar Channel
+//O(1) per sample & fixed size. update() returns true when it fires and leaves the value & timestamp
+//of the sample that caused it in detectedValue/detectedTime
+class Detector
+{
+public:
+  Detector(uint8_t watchChannel) { channel = watchChannel; };
+  virtual ~Detector() {};
+
+  uint8_t channel;
+
+  float detectedValue = 0;
+  unsigned long detectedTime = 0;
+
+  virtual bool update(float value, unsigned long t) = 0;
+  virtual void reset() {};
+};
+
+//Peak (Or Valley) With Hysteresis. Fires once the signal retreats hysteresis from the extreme,
+//reporting the extreme itself. Needs to come back by hysteresis before it looks for the next one
+class ExtremumDetector: public Detector
+{
+public:
+  ExtremumDetector(uint8_t watchChannel, float hyst, bool findMaximum = true):
+    Detector(watchChannel) { hysteresis = hyst; maximum = findMaximum; reset(); };
+
+  float hysteresis;
+  bool maximum;
+
+  virtual bool update(float value, unsigned long t);
+  virtual void reset() { _seeking = true; _started = false; };
+
+private:
+  bool _seeking;        //Looking for the extreme (vs waiting for the signal to come back)
+  bool _started;
+  float _extreme;
+  unsigned long _extremeTime;
+};
+
+#endif
@@ -1,10 +1,25 @@
 #include "application.h"
+
+#ifndef _INCL_EVENT
+#define _INCL_EVENT
+
 #include "3dmath.h"
+#include "impact.h"
+
+//Compile Time Event Type IDs, Index The EventBus Handler Tables
+enum EventTypeId {
+  EVENT_GENERIC = 0,
+  EVENT_MOTION,
+  EVENT_COM,
+  EVENT_IMPACT,
+  EVENT_GESTURE,
+  EVENT_TRANSITION,
+  NUM_EVENT_TYPES
+};
 
 //Fwd Declaration
 class State;
 class MotionState;
-class Subject;
 class Observer;
 class StateSwitch;
 class Game;
@@ -13,60 +28,159 @@ class IEvent
 {
   virtual void visit(State *s) =0;
   virtual void visit(MotionState *s) =0;
-  virtual void visit(Subject *sj) = 0;
   virtual void visit(Observer *o) =0;
   virtual void visit(StateSwitch *s) =0; //State
 
-  virtual String type()=0;
+  virtual const char* type()=0;
 };
 
 class Event: public IEvent{
 public:
+  static const uint8_t TYPE_ID = EVENT_GENERIC;
   Event(){};
   ~Event() {};
   String msg;
   //Should Return The Type Of Event
   virtual void visit(State *s); //State
   virtual void visit(MotionState *s);
-  virtual void visit(Subject *sj); //Subject
   virtual void visit(Observer *o); //Observer
   virtual void visit(StateSwitch *s); //State
 
-  virtual String type() {return "Event";};
+  virtual const char* type() {return "Event";};
+};
+
+//Min/Max Of The Samples Folded Into A Coalesced MotionEvent, See EventBus
+struct MotionEnvelope {
+  VectorFloat Gmin, Gmax, Amin, Amax;
 };
 
 class MotionEvent: public Event
 {
 public:
-  MotionEvent(){};
-  MotionEvent( VectorFloat &Gin, VectorFloat &Ain, VectorFloat &Vin, VectorFloat &Xin);
+  static const uint8_t TYPE_ID = EVENT_MOTION;
+  MotionEvent(): t(0) {};
+  MotionEvent( VectorFloat &Gin, VectorFloat &Ain, VectorFloat &Vin, VectorFloat &Xin, unsigned long tin);
   ~MotionEvent(){};
 
-  virtual String type() {return "MotionEvent";};
+  virtual const char* type() {return "MotionEvent";};
 
   //Should Return The Type Of Event
   virtual void visit(State *s); //State
   virtual void visit(MotionState *s);
-  virtual void visit(Subject *sj); //Subject
   virtual void visit(Observer *o); //Observer
   virtual void visit(StateSwitch *s); //State
 
   VectorFloat G,A,V,X;
+  VectorFloat Alin; //Gravity removed, sensor frame
+  unsigned long t; //micros() the sample was fused
+  uint32_t seq = 0; //MotionEventPool sequence, 0 if the event didn't come from a pool
+  uint32_t sampleSeq = 0;      //Raw sample this was fused from, see MPU_9250::sampleSeq
+  unsigned long captured = 0;  //micros() that sample was read
+
+  //Set By The EventBus For Rate Limited Subscribers
+  uint16_t samples = 1;               //Samples this delivery stands for
+  MotionEnvelope *envelope = NULL;    //Only for COALESCE_ENVELOPE deliveries
+};
+
+#define MOTION_EVENT_POOL 4 //Power Of Two
+
+//Preallocated Ring Of MotionEvents
+//The acquisition stage takes the next slot & writes the sample into it, observers get a reference to the slot.
+//A slot stays untouched for MOTION_EVENT_POOL - 1 more samples, so holding a pointer to a recent event is safe
+class MotionEventPool
+{
+public:
+  //Next Slot, Stamped With A New Sequence Number. Payload Is Left For The Caller To Fill
+  MotionEvent& acquire()
+  {
+    MotionEvent &motion = _slots[ ++_seq & (MOTION_EVENT_POOL - 1) ];
+    motion.seq = _seq;
+    return motion;
+  };
+
+  MotionEvent& current() { return _slots[ _seq & (MOTION_EVENT_POOL - 1) ]; };
+
+  //age 0 is current(), NULL once the slot has been reused or was never written
+  MotionEvent* recent(uint8_t age)
+  {
+    if ( age >= MOTION_EVENT_POOL || age >= _seq ) return NULL;
+    return &_slots[ (_seq - age) & (MOTION_EVENT_POOL - 1) ];
+  };
+
+  uint32_t sequence() { return _seq; };
+
+private:
+  MotionEvent _slots[MOTION_EVENT_POOL];
+  uint32_t _seq = 0;
 };
 
 
 class COMEvent: public Event {
 public:
+  static const uint8_t TYPE_ID = EVENT_COM;
   COMEvent(String newMessage){message = newMessage;};
   ~COMEvent(){};
 
-  virtual String type() {return "COMEvent";};
+  virtual const char* type() {return "COMEvent";};
 
   //Should Return The Type Of Event
   virtual void visit(State *s); //State
-  virtual void visit(Subject *sj); //Subject
   virtual void visit(Observer *o); //Observer
   virtual void visit(StateSwitch *s); //State
 
   String message;
 };
+
+//Catch, Ground Or Wall Hit From The ImpactDetector
+class ImpactEvent: public Event {
+public:
+  static const uint8_t TYPE_ID = EVENT_IMPACT;
+  ImpactEvent(ImpactRecord &record){ impact = record; };
+  ~ImpactEvent(){};
+
+  virtual const char* type() {return "ImpactEvent";};
+
+  //Should Return The Type Of Event
+  virtual void visit(State *s); //State
+  virtual void visit(Observer *o); //Observer
+  virtual void visit(StateSwitch *s); //State
+
+  ImpactRecord impact;
+};
+
+//Recognized By The GestureEngine
+class GestureEvent: public Event {
+public:
+  static const uint8_t TYPE_ID = EVENT_GESTURE;
+  GestureEvent(uint8_t gestureSlot, uint16_t matchDistance, unsigned long time)
+  { gesture = gestureSlot; distance = matchDistance; t = time; };
+  ~GestureEvent(){};
+
+  virtual const char* type() {return "GestureEvent";};
+
+  //Should Return The Type Of Event
+  virtual void visit(State *s); //State
+  virtual void visit(Observer *o); //Observer
+  virtual void visit(StateSwitch *s); //State
+
+  uint8_t gesture;   //Template slot, see GestureSlots
+  uint16_t distance; //DTW distance of the match
+  unsigned long t;
+};
+
+//MotionSwitch Changed Phase, Published Once The New State Has Been Entered
+class TransitionEvent: public Event {
+public:
+  static const uint8_t TYPE_ID = EVENT_TRANSITION;
+  TransitionEvent(int fromState, int toState, unsigned long time)
+  { from = fromState; to = toState; t = time; };
+  ~TransitionEvent(){};
+
+  virtual const char* type() {return "TransitionEvent";};
+
+  int from; //MotionSwitch::MotionStates
+  int to;
+  unsigned long t;
+};
+
+#endif
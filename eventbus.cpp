@@ -0,0 +1,172 @@
+#include "eventbus.h"
+#import "observer.h"
+
+bool EventBus::add(uint8_t typeId, Thunk thunk, void *target, float rateHz, uint8_t policy, MotionTrigger trigger)
+{
+  if ( _count[typeId] >= MAX_HANDLERS_PER_EVENT ) return false;
+  if ( typeId == EVENT_MOTION ) _coalesce[ _count[typeId] ].count = 0;
+  Handler &h = _handlers[typeId][ _count[typeId]++ ];
+  h.thunk = thunk;
+  h.target = target;
+  h.interval = rateHz > 0 ? 1000000 / rateHz : 0;
+  h.last = 0;
+  h.policy = policy;
+  h.trigger = trigger;
+  h.enabled = true;
+  return true;
+}
+
+void EventBus::enable(void *target, bool on)
+{
+  for (uint8_t type = 0; type < NUM_EVENT_TYPES; type++){
+    for (uint8_t i = 0; i < _count[type]; i++){
+      Handler &h = _handlers[type][i];
+      if ( h.target != target ) continue;
+      h.enabled = on;
+      if ( type == EVENT_MOTION ){ //Don't Hand Over A Summary From Before The Pause
+        _coalesce[i].count = 0;
+        h.last = 0;
+      }
+    }
+  }
+}
+
+void EventBus::publish(MotionEvent &motion)
+{
+  Handler *handlers = _handlers[EVENT_MOTION];
+  uint8_t count = _count[EVENT_MOTION];
+  for (uint8_t i = 0; i < count; i++){
+    Handler &h = handlers[i];
+    if ( !h.enabled ) continue;
+    //Full Rate, Straight Through
+    if ( h.interval == 0 ){
+      h.thunk( h.target, &motion );
+      continue;
+    }
+
+    MotionAggregate &agg = _coalesce[i];
+    fold( agg, h.policy, motion );
+    bool due = motion.t - h.last >= h.interval;
+    if ( h.policy == COALESCE_ANY && h.trigger != NULL && h.trigger( motion ) ) due = true;
+    if ( !due ) continue;
+
+    h.last = motion.t;
+    deliver( h, agg, motion );
+  }
+}
+
+//Componentwise Extremes
+static void envelopeMin(VectorFloat &bound, VectorFloat &v)
+{
+  if ( v.x < bound.x ) bound.x = v.x;
+  if ( v.y < bound.y ) bound.y = v.y;
+  if ( v.z < bound.z ) bound.z = v.z;
+}
+
+static void envelopeMax(VectorFloat &bound, VectorFloat &v)
+{
+  if ( v.x > bound.x ) bound.x = v.x;
+  if ( v.y > bound.y ) bound.y = v.y;
+  if ( v.z > bound.z ) bound.z = v.z;
+}
+
+static void accumulate(VectorFloat &sum, VectorFloat &v)
+{
+  sum.x += v.x; sum.y += v.y; sum.z += v.z;
+}
+
+void EventBus::fold(MotionAggregate &agg, uint8_t policy, MotionEvent &motion)
+{
+  agg.count++;
+  if ( policy == COALESCE_MEAN ){
+    if ( agg.count == 1 ){
+      agg.mean.G = motion.G; agg.mean.A = motion.A; agg.mean.V = motion.V; agg.mean.X = motion.X;
+      agg.mean.Alin = motion.Alin;
+    }
+    else {
+      accumulate( agg.mean.G, motion.G ); accumulate( agg.mean.A, motion.A );
+      accumulate( agg.mean.V, motion.V ); accumulate( agg.mean.X, motion.X );
+      accumulate( agg.mean.Alin, motion.Alin );
+    }
+  }
+  else if ( policy == COALESCE_ENVELOPE ){
+    MotionEnvelope &env = agg.envelope;
+    if ( agg.count == 1 ){
+      env.Gmin = motion.G; env.Gmax = motion.G; env.Amin = motion.A; env.Amax = motion.A;
+    }
+    else {
+      envelopeMin( env.Gmin, motion.G ); envelopeMax( env.Gmax, motion.G );
+      envelopeMin( env.Amin, motion.A ); envelopeMax( env.Amax, motion.A );
+    }
+  }
+}
+
+void EventBus::deliver(Handler &h, MotionAggregate &agg, MotionEvent &motion)
+{
+  if ( h.policy == COALESCE_MEAN ){
+    float n = agg.count;
+    MotionEvent &mean = agg.mean;
+    mean.G.x /= n; mean.G.y /= n; mean.G.z /= n;
+    mean.A.x /= n; mean.A.y /= n; mean.A.z /= n;
+    mean.V.x /= n; mean.V.y /= n; mean.V.z /= n;
+    mean.X.x /= n; mean.X.y /= n; mean.X.z /= n;
+    mean.Alin.x /= n; mean.Alin.y /= n; mean.Alin.z /= n;
+    //Stamps Are The Newest Sample's, Latency & Dedupe Follow It
+    mean.t = motion.t;
+    mean.seq = motion.seq;
+    mean.sampleSeq = motion.sampleSeq;
+    mean.captured = motion.captured;
+    mean.samples = agg.count;
+    h.thunk( h.target, &mean );
+  }
+  else { //The Pooled Event Is Shared, Put It Back How We Found It
+    motion.samples = agg.count;
+    if ( h.policy == COALESCE_ENVELOPE ) motion.envelope = &agg.envelope;
+    h.thunk( h.target, &motion );
+    motion.samples = 1;
+    motion.envelope = NULL;
+  }
+  agg.count = 0;
+}
+
+//Counts Deliveries So Neither Path Can Be Optimized Away
+class BenchObserver: public Observer
+{
+public:
+  using Observer::onNotify;
+  uint32_t received = 0;
+  virtual void onNotify( MotionEvent &motion ){ received++; };
+  void onMotion( MotionEvent &motion ){ received++; };
+};
+
+void benchmarkEventDispatch(uint32_t iterations, uint8_t observers, uint32_t &visitorMicros, uint32_t &busMicros)
+{
+  //A Bus Is A Few KB, Too Much For The Loop Stack. Built Once, The Count Is Set By Pausing The Rest
+  static BenchObserver targets[MAX_HANDLERS_PER_EVENT];
+  static EventBus bus;
+  static bool wired = false;
+  if ( !wired ){
+    for (uint8_t i = 0; i < MAX_HANDLERS_PER_EVENT; i++){
+      bus.subscribe<MotionEvent, BenchObserver, &BenchObserver::onMotion>( &targets[i] );
+    }
+    wired = true;
+  }
+  if ( observers > MAX_HANDLERS_PER_EVENT ) observers = MAX_HANDLERS_PER_EVENT;
+  for (uint8_t i = 0; i < MAX_HANDLERS_PER_EVENT; i++){ bus.enable( &targets[i], i < observers ); }
+
+  //Same Payload Both Ways
+  VectorFloat G, A, V, X;
+  MotionEvent motion( G, A, V, X, micros() );
+
+  uint32_t start = micros();
+  for (uint32_t n = 0; n < iterations; n++){
+    for (uint8_t i = 0; i < observers; i++){ motion.visit( &targets[i] ); }
+  }
+  visitorMicros = micros() - start;
+
+  start = micros();
+  for (uint32_t n = 0; n < iterations; n++){
+    bus.publish( motion );
+  }
+  busMicros = micros() - start;
+}
@@ -0,0 +1,95 @@
+#include "application.h"
+
+#ifndef _INCL_EVENTBUS
+#define _INCL_EVENTBUS
+
+#include "event.h"
+
+#define MAX_HANDLERS_PER_EVENT 8
+
+//How A Rate Limited MotionEvent Subscriber Sees The Samples Between Its Deliveries
+enum CoalescePolicy {
+  COALESCE_LATEST = 0, //Newest sample
+  COALESCE_MEAN,       //G/A/V/X averaged over the skipped samples
+  COALESCE_ENVELOPE,   //Newest sample, with min/max of G & A in motion.envelope
+  COALESCE_ANY         //Newest sample at the rate, or right away when the trigger fires
+};
+
+typedef bool (*MotionTrigger)(MotionEvent &motion);
+
+//Statically Typed Event Bus
+//Handlers are bound per event type at compile time (Event::TYPE_ID) through a template thunk, so publishing is
+//a table walk with one indirect call per handler. No virtual visit() hop, no type() strings, no heap.
+//  bus.subscribe<MotionEvent, MotionSwitch, &MotionSwitch::handleInput>( &frisbeem._motionState );
+//  bus.publish( motionEvent );
+//MotionEvent subscribers can also ask for a rate in Hz & a CoalescePolicy. The bus folds the samples in between
+//into per subscriber storage & only calls the handler when its interval is up, motion.samples says how many it covers
+//  bus.subscribe<MotionEvent, Scoreboard, &Scoreboard::onNotify>( &scoreboard, 50, COALESCE_ENVELOPE );
+class EventBus
+{
+public:
+  typedef void (*Thunk)(void *target, void *payload);
+
+  struct Handler {
+    Thunk thunk;
+    void *target;
+    unsigned long interval; //Micros between deliveries, 0 for every event
+    unsigned long last;     //motion.t of the last delivery
+    uint8_t policy;
+    MotionTrigger trigger;
+    bool enabled;
+  };
+
+  //Bind target->Method as a handler for events of type E. Returns false when E's table is full
+  //rateHz, policy & trigger only apply to MotionEvents, anything else is delivered every time
+  template <typename E, typename T, void (T::*Method)(E&)>
+  bool subscribe(T *target, float rateHz = 0, uint8_t policy = COALESCE_LATEST, MotionTrigger trigger = NULL)
+  {
+    return add( E::TYPE_ID, &invoke<E, T, Method>, target, rateHz, policy, trigger );
+  }
+
+  template <typename E>
+  void publish(E &event)
+  {
+    Handler *handlers = _handlers[E::TYPE_ID];
+    uint8_t count = _count[E::TYPE_ID];
+    for (uint8_t i = 0; i < count; i++){
+      if ( handlers[i].enabled ) handlers[i].thunk( handlers[i].target, &event );
+    }
+  }
+
+  //Pause Or Resume Every Handler Bound To target, Bounded By The Table Size. Nothing Is Moved Or Allocated
+  void enable(void *target, bool on);
+
+  //Motion Goes Through Rate Limiting & Coalescing
+  void publish(MotionEvent &motion);
+
+  uint8_t subscribers(uint8_t typeId) { return _count[typeId]; };
+
+private:
+  //Folded Samples Of One Rate Limited Motion Subscriber
+  struct MotionAggregate {
+    MotionEvent mean;
+    MotionEnvelope envelope;
+    uint16_t count;
+  };
+
+  template <typename E, typename T, void (T::*Method)(E&)>
+  static void invoke(void *target, void *payload)
+  {
+    (static_cast<T*>(target)->*Method)( *static_cast<E*>(payload) );
+  }
+
+  bool add(uint8_t typeId, Thunk thunk, void *target, float rateHz, uint8_t policy, MotionTrigger trigger);
+  void fold(MotionAggregate &agg, uint8_t policy, MotionEvent &motion);
+  void deliver(Handler &h, MotionAggregate &agg, MotionEvent &motion);
+
+  Handler _handlers[NUM_EVENT_TYPES][MAX_HANDLERS_PER_EVENT];
+  uint8_t _count[NUM_EVENT_TYPES] = {0};
+  MotionAggregate _coalesce[MAX_HANDLERS_PER_EVENT]; //Lines up with _handlers[EVENT_MOTION]
+};
+
+//Times iterations MotionEvent dispatches to observers handlers through the old visitor path & the bus
+void benchmarkEventDispatch(uint32_t iterations, uint8_t observers, uint32_t &visitorMicros, uint32_t &busMicros);
+
+#endif
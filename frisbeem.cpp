@@ -1,6 +1,48 @@
 #include "frisbeem.h"
 #include "games.h"
 
+//Deferred Calls
+static void sendTelemetry(void *target, void *payload){ static_cast<COM*>(target) -> send_telemetry(); }
+
+static void publishImpact(void *target, void *payload)
+{
+  Frisbeem *beem = static_cast<Frisbeem*>(target);
+  ImpactRecord *record = static_cast<ImpactRecord*>(payload);
+  ImpactEvent impactEvent( *record );
+  beem -> _bus.publish( impactEvent );
+  beem -> _session.sendEvent( SESSION_IMPACT, record -> kind, record -> peakG * 100 );
+}
+
+struct GestureHit {
+  uint8_t gesture;
+  uint16_t distance;
+  unsigned long t;
+};
+
+static void publishGesture(void *target, void *payload)
+{
+  GestureHit *hit = static_cast<GestureHit*>(payload);
+  Frisbeem *beem = static_cast<Frisbeem*>(target);
+  GestureEvent gestureEvent( hit -> gesture, hit -> distance, hit -> t );
+  beem -> _bus.publish( gestureEvent );
+  beem -> _session.sendEvent( SESSION_GESTURE, hit -> gesture, hit -> distance );
+}
+
+static void povPush(void *target, const uint32_t *frame, uint8_t leds)
+{
+  Adafruit_DotStar *strip = static_cast<Adafruit_DotStar*>(target);
+  for (uint8_t i = 0; i < leds; i++){ strip -> setPixelColor( i, frame[i] ); }
+  strip -> show(); //From The Loop, Lights Keeps Off The Strip While POV Is Enabled
+}
+
+static void zuptUpdate(void *target, ZuptIntegrator &zupt){ static_cast<ThrowMetrics*>(target) -> revise( zupt ); }
+
+static void peerEvent(void *target, SessionPeer &peer, SessionEvent &event)
+{
+  static_cast<Frisbeem*>(target) -> _com.telemetry("PEV", String(peer.disc)+","+String(event.kind)+","+
+                                                    String(event.detail)+","+String(event.value)+","+String(event.at)+";");
+}
+
 void Frisbeem::initlaize(){
   //Initalize communication
   _com.initialize();
@@ -9,13 +51,37 @@ void Frisbeem::initlaize(){
   //Update MPU
   _com.log("Go For Brains");
   _mpu.initialize();
+  _mpu.zupt.onUpdate = &zuptUpdate;
+  _mpu.zupt.updateTarget = &_throwMetrics;
   //Update Strip
   _com.log("Go For Lights");
   _lights.initlaize();
+  _pov.ringLayout( NUM_LED );
+  _pov.push = &povPush;
+  _pov.pushTarget = &_lights._strip;
+  _povTimer.begin( _pov );
+  for (uint8_t i = 1; i < POV_PALETTE; i++){ _pov.palette[i] = _lights.wheel( (i - 1) * 256 / (POV_PALETTE - 1) ); }
+  loadPovImage( 0 );
+
+  _com.log("Joining Session");
+  joinSession();
+
+  _com.log("Loading Gestures");
+  _gestures.loadDefaults();
+  _gestures.load(); //Recorded Templates Replace The Defaults
+
+  _com.log("Wiring The Bus");
+  _bus.subscribe<MotionEvent, MotionSwitch, &MotionSwitch::handleInput>( &_motionState ); //State Goes First
+  _bus.subscribe<GestureEvent, Frisbeem, &Frisbeem::onGesture>( this );
+  _bus.subscribe<TransitionEvent, ThrowMetrics, &ThrowMetrics::onTransition>( &_throwMetrics ); //Before Scripts
+  _scripts.subscribe( _bus );
+  _motionState.trackHistory( _history );
 
   _com.log("Listening To Game");
-  Firework *_currentGame = new Firework();
-  addObserver( _currentGame );
+  _gameMode.add( &_firework, _bus );
+  _gameMode.add( &_spinCount, _bus );
+  _gameMode.add( &_catchScore, _bus );
+  for (uint8_t i = 0; i < _gameMode.numGames; i++){ _gameMode.activate( i, true ); } //Play Them All
 
   //Serial.println("Motion State Creation");
   _com.log("Go For Loop");
@@ -30,6 +96,15 @@ void Frisbeem::update(){
   _com.log("Beeming Into Space...");
   //Update COM layer
   _com.update();
+  //Power Mode Follows Activity
+  _power.update();
+  //POV Columns Are Latched From The Timer, It Only Ticks While There's Something To Draw
+  _povTimer.run( _pov.enabled && _power.lightsOn() );
+  //Swap State With Other Discs
+  if ( !_com.wifiOff ){
+    _session.setState( _motionState.currentState, _power.currentState, _catchScore.streak, constrain( _mpu.G.z, -32767.0f, 32767.0f ) );
+    _session.update();
+  }
 
   //Handle Other Stuff
   _com.log("Updating...");
@@ -39,10 +114,21 @@ void Frisbeem::update(){
   while ( micros() - start < renderInterval) {
     _com.log("Updating MPU");
     _mpu.update();
-    updateThetaOffset();
-    processMotion();
-    //Send telemetry here... idk?
-    _com.send_telemetry();
+    //Events, Latency & Telemetry Are Per Sample, Not Per Pass. Nothing New Means Nothing To Report
+    if ( _mpu.sampleSeq != processedSeq ){
+      processedSeq = _mpu.sampleSeq;
+      updateThetaOffset();
+      processMotion();
+      //The Timer Latches Columns, They Go Out Between Each Stage
+      _pov.show( micros() );
+      //Telemetry Waits Behind Game Work, One Pending At A Time
+      _deferred.post( PRIORITY_REPORT, &sendTelemetry, &_com, NULL, 0, true );
+    }
+    _deferred.dispatch( deferredBudget );
+    //Game Updates That Are Due, Within frameBudget
+    _gameMode.update();
+    _pov.show( micros() );
+    if ( _power.profile().loopDelay > 0 ){ delay( _power.profile().loopDelay ); }
   }
   //Initialize Lights
   _com.log("Puttin On The High Beems!");
@@ -52,6 +138,62 @@ void Frisbeem::update(){
   _com.close();
 }
 
+void Frisbeem::joinSession()
+{ //Disc Id Is The Last Octet Of Our Address, Unique On A /24
+  _session.begin( &_sessionLink, WiFi.localIP()[3] );
+  _session.onEvent = &peerEvent;
+  _session.eventTarget = this;
+}
+
+void Frisbeem::onGesture(GestureEvent &gesture)
+{
+  if ( gesture.gesture >= MAX_GESTURES ) return;
+  switch ( _gestures.actions[ gesture.gesture ] ){
+    case ACTION_LIGHTS: _lights._on = !_lights._on; break;
+    case ACTION_CALIBRATE: calibrate(); break;
+    case ACTION_POV: _pov.enabled = !_pov.enabled; break;
+    case ACTION_NEXT_GAME: //After The Last Active One, Round To The First
+      for (uint8_t i = _gameMode.numGames; i > 0; i--){
+        if ( _gameMode.active( i - 1 ) ){ _gameMode.switchTo( i % _gameMode.numGames ); return; }
+      }
+      _gameMode.switchTo( 0 );
+      break;
+  }
+}
+
+void Frisbeem::calibrate()
+{ //Calibrate Gyro & Accelerometers, Load Biases In Bias Registers
+  _mpu.calibrateMPU9250( _mpu.gyroBias, _mpu.accelBias );
+  delay(1000);
+  _mpu.initMPU9250();
+  _mpu.Axy_lp = 0;
+  _mpu.seedAttitude();
+}
+
+void Frisbeem::loadPovImage(uint8_t image)
+{
+  _pov.clear();
+  switch ( image ){
+    case 1: //Colour Wheel Fixed In The World
+      _pov.gradient();
+      break;
+    default: //Marker Where The Disc Started, Shows Which Way It's Turning
+      _pov.arc( -15, 15, 1 );
+      _pov.arc( 90, 95, 6 );
+      _pov.arc( 180, 185, 6 );
+      _pov.arc( 270, 275, 6 );
+      break;
+  }
+}
+
+void Frisbeem::setFrameRate(uint8_t fps)
+{
+  if ( fps == 0 ){ renderInterval = darkInterval; return; }
+  targetFPS = fps;
+  uint32_t frame = 1000000 / targetFPS;
+  renderInterval = frame > budgetRefreshTime ? frame - budgetRefreshTime : frame;
+}
+
 void Frisbeem::updateThetaOffset()
 {
   thisTime = micros();
@@ -69,21 +211,58 @@ void Frisbeem::updateThetaOffset()
   }
 
   lightOffset = thetaOffset / degPerPixel;
+  //Same Deadband As The Integration Above
+  _pov.setPhase( thetaOffset, abs(_mpu.G.z) > 0.1 ? -_mpu.G.z : 0, thisTime );
 
   //Preserve Time Calculations
   lastTime = thisTime;
 }
 
 void Frisbeem::processMotion()
-{ //Generate A New Event & Add to circular buffer after deleting current item
-  //Serial.print("Getting New Event #");Serial.println(_eventCount);
-  currentMotionEvent = genNextEvent();
-  currentMotionEvent.visit( &_motionState );//StateSwitchCall
-  currentMotionEvent.visit( this );//Subject Call notify()
+{ //Write The Sample Into The Next Pool Slot, Everyone Downstream Gets A Reference To It
+  MotionEvent &motion = genNextEvent();
+  currentMotionEvent = &motion;
+  _history.record( motion );
+  //Refined Height Comes Out A Few Lags Behind The Live One. Stillness Is As Of The Last Sample
+  smoothedReady = _smoother.update( _mpu.now, _mpu.Awrld.z, _motionState.stationary(), smoothedPoint );
+  _bus.publish( motion ); //MotionSwitch, Then Games
+  if ( !_motionState.stationary() ){ _power.noteMotion(); }
+  _latency.record( LAT_EVENT, motion.captured );
+  _scripts.tick( motion ); //Timeouts & Apogee, Only When Some Script Waits On Them
+  _throwMetrics.update( motion, _mpu.q );
+  //Apogee & Peak Height Go On The Smoothed Track While It Runs
+  if ( !_smoother.enabled ){
+    _scripts.height( motion.X.z, motion.t );
+    _throwMetrics.height( motion.X.z, motion.t );
+  }
+  else if ( smoothedReady ){
+    _scripts.height( smoothedPoint.z, smoothedPoint.t );
+    _throwMetrics.height( smoothedPoint.z, smoothedPoint.t );
+  }
+
+  //Impacts Are Caught Per Raw Sample In The MPU, Hand Them On Once. Games Get Them After The Physics Step
+  if ( _mpu.impact.pending ){
+    _mpu.impact.pending = false;
+    _deferred.post( PRIORITY_GAME, &publishImpact, this, &_mpu.impact.last, sizeof(ImpactRecord) );
+  }
+
+  if ( _gestures.update( motion ) ){
+    GestureHit hit = { _gestures.lastGesture, _gestures.lastDistance, _gestures.lastTime };
+    _deferred.post( PRIORITY_GAME, &publishGesture, this, &hit, sizeof(GestureHit) );
+  }
 
 }
 
-MotionEvent Frisbeem::genNextEvent()
-{ //For Now Look At Omegea (w)
-  return MotionEvent( _mpu.G, _mpu.A, _mpu.V, _mpu.X );
+MotionEvent& Frisbeem::genNextEvent()
+{ //Fill In Place, No Temporary Event Or Assignment Per Sample
+  MotionEvent &motion = _motionEvents.acquire();
+  motion.G = _mpu.G;
+  motion.A = _mpu.A;
+  motion.Alin = _mpu.Alin;
+  motion.V = _mpu.V;
+  motion.X = _mpu.X;
+  motion.t = _mpu.now;
+  motion.sampleSeq = _mpu.sampleSeq;
+  motion.captured = _mpu.sampleTime;
+  return motion;
 }
@@ -4,18 +4,28 @@
 #include "communication.h"
 #include "state.h"
 #include "entity.h"
-#include "subject.h"
 #include "event.h"
-//#include "games.h"
+#include "eventbus.h"
+#include "smoother.h"
+#include "throwmetrics.h"
+#include "gestures.h"
+#include "motionhistory.h"
+#include "latency.h"
+#include "scripts.h"
+#include "deferred.h"
+#include "power.h"
+#include "games.h"
+#include "session.h"
+#include "udptransport.h"
+#include "pov.h"
+#include "povtimer.h"
 
 using namespace std;
 
 //WARNING:: SPELLING MAY BE EXTREMELY BAD!!!
-class Game;
-class Firework;
 
 //In which we combine Lights + Motion + Games
-class Frisbeem: public Subject, public Entity
+class Frisbeem: public Entity
 {
 public:
   Frisbeem(): _mpu(), _lights(), _com(){};//Constructor
@@ -24,21 +34,63 @@ public:
   //Physical parameters
 
   //States
-  // StateSwitch _powerState;
+  PowerSwitch _power;
   MotionSwitch _motionState;
-  // StateSwitch _gameMode;
+  GameSwitch _gameMode;
+
+  //Games, All Built Up Front. Indexes Follow The Order They're Added In initlaize
+  Firework _firework;
+  SpinCount _spinCount;
+  CatchScore _catchScore;
 
   //Hardware
   MPU_9250 _mpu;
   Lights _lights;
+  //Spin Locked Images, Takes The Strip Over From _lights While Running
+  PovRenderer _pov;
+  PovTimer _povTimer;
+  void loadPovImage(uint8_t image);
 
   //Connection
   COM _com;
 
+  //Other Discs On The LAN
+  Session _session;
+  UDPTransport _sessionLink;
+  void joinSession();
+
+  //Gesture Commands
+  GestureEngine _gestures;
+  void onGesture(GestureEvent &gesture); //Runs the action mapped to its slot
+  void calibrate();
+
+  //Game & Reporting Work, Run After Each Physics Step Within deferredBudget
+  DeferredQueue _deferred;
+  unsigned long deferredBudget = 500; //Microseconds
+
+  //Suspended Game Scripts
+  ScriptRunner _scripts;
+
+  //Sample To Output Latency, Per Stage
+  LatencyTracker _latency;
+
+  //Per Throw Summaries
+  ThrowMetrics _throwMetrics;
+
+  //Lagged Trajectory Refinement (Optional, See TrajectorySmoother)
+  TrajectorySmoother _smoother;
+  TrajectoryPoint smoothedPoint;
+  bool smoothedReady = false;
+
   //Events
-  MotionEvent currentMotionEvent;
+  EventBus _bus;
+  MotionEventPool _motionEvents;
+  MotionEvent *currentMotionEvent = NULL;
+  uint32_t processedSeq = 0; //Last MPU sampleSeq that went through processMotion
+  //Last HISTORY_SIZE Samples For Windowed Queries
+  MotionHistory _history;
   //Event Functions
-  MotionEvent genNextEvent();
+  MotionEvent& genNextEvent();
   void processMotion();
 
   //Important Entity Functions
@@ -50,6 +102,8 @@ public:
   int targetFPS = 20;
   uint32_t budgetRefreshTime = 2500;
   uint32_t renderInterval = (1000000 / targetFPS) - budgetRefreshTime; //Microseconds aka 60fps
+  uint32_t darkInterval = 100000; //Frame interval while the strip is off
+  void setFrameRate(uint8_t fps);
   //Sandbox Functions
   unsigned long lastTime,thisTime;
   int lightOffset = 0;
@@ -1,37 +1,61 @@
 #include "games.h"
 #include "globals.h"
 
-void Firework::onNotify( MotionEvent &motion)
-{
-  frisbeem._com.log("Firework Notified");
-  //Check New Data To See Parse Informatoin
-  if ( motion.G.z > 300)
-  {
-    //Check Height:
-    //If Height is greater than the max, set maxHeight
-    //otherwise
-    if ( motion.X.z > maxHeight )
-    {
-      maxHeight = motion.X.z;
-    }
-    else
-    {
-      //Check Velocity:
-      //If Velocity Is Negative In Z and a max has not been detected
-      //Set Flag & Send Signal
-      if ( motion.V.z < 0 && !peakDetected){
-        peakDetected = true;
-        //If There's a good increase in altitude... lets play a sound
-        if (maxHeight > 2){ frisbeem._com.sendCommand("AUD","PLY","BNG"); }
-      }
-    }
-  }
-  else{
-    //Not Spinning
-    maxHeight = 0;
-    peakDetected = false;
+static void playBang(void *target, void *payload){ frisbeem._com.sendCommand("AUD","PLY","BNG"); }
+
+static void sendScore(void *target, void *payload)
+{
+  CatchScore *game = static_cast<CatchScore*>(target);
+  frisbeem._com.telemetry("SCR", String(game -> streak)+","+String(game -> best)+";");
+}
+
+void Game::subscribe(EventBus &bus)
+{ //Goes Through The Virtual onNotify, So Overrides In Subclasses Are Picked Up
+  //Scripted Games Sleep On The ScriptRunner Until Their Await Fires, No Per Sample Calls
+  if ( wantsMotion && !scripted ){ bus.subscribe<MotionEvent, Game, &Game::deliver<MotionEvent> >( this, motionRate, motionPolicy ); }
+  bus.subscribe<ImpactEvent, Game, &Game::deliverEvent<ImpactEvent> >( this );
+  bus.subscribe<GestureEvent, Game, &Game::deliverEvent<GestureEvent> >( this );
+}
+
+bool Game::admit()
+{
+  GameCost &c = deliveryCost;
+  if ( (long)(micros() - c.nextRun) < 0 || ( c.divider > 1 && ++c.skip < c.divider ) ){
+    c.deferred++;
+    return false;
   }
+  c.skip = 0;
+  return true;
+}
 
+void Game::delivered(uint32_t t0)
+{ //Parking Counts From This Delivery
+  deliveryCost.nextRun = t0;
+  deliveryCost.account( micros() - t0, deliveryBudget );
+}
+
+bool Game::runScript(ScriptFrame &f)
+{
+  if ( !admit() ) return false;
+  uint32_t t0 = micros();
+  script( f );
+  delivered( t0 );
+  return true;
+}
+
+void Firework::script(ScriptFrame &f)
+{
+  SCRIPT_BEGIN(f);
+  while (true){
+    SCRIPT_AWAIT(f, AWAIT_FLIGHT, 0);
+    //Came Down Before A Peak, Nothing To Celebrate
+    SCRIPT_AWAIT(f, AWAIT_APOGEE | AWAIT_CATCH | AWAIT_LANDED, maxFlightTime);
+    //If There's a good increase in altitude... lets play a sound
+    if ( (f.fired & AWAIT_APOGEE) && frisbeem._scripts.apogeeHeight > minPeakHeight ){
+      frisbeem._deferred.post( PRIORITY_REPORT, &playBang, NULL ); //Don't Hold Up The Transition On The Socket
+    }
+  }
+  SCRIPT_END(f);
 }
 
 void Firework::update()
@@ -40,3 +64,164 @@ void Firework::update()
 
   //Check If Peak Conditions Are Met... Then Send A Signal
 }
+
+static void sendSpins(void *target, void *payload)
+{
+  SpinCount *game = static_cast<SpinCount*>(target);
+  frisbeem._com.telemetry("SPN", String(game -> spins)+","+String(game -> best)+";");
+}
+
+void SpinCount::enter()
+{
+  spins = 0;
+  inFlight = false;
+}
+
+void SpinCount::onNotify( MotionEvent &motion)
+{ //Mean Spin Rate Over The Samples Since The Last Delivery, Times The Time They Span
+  bool flying = frisbeem._motionState.currentState == MotionSwitch::FLIGHT;
+  if ( flying ){
+    if ( !inFlight ){ spins = 0; } //New Throw
+    else { spins += fabs( motion.G.z ) * (motion.t - lastUpdate) / 360E6; }
+  }
+  else if ( inFlight ){ //Came Down, Report The Throw
+    if ( spins > best ) best = spins;
+    frisbeem._deferred.post( PRIORITY_REPORT, &sendSpins, this );
+  }
+  inFlight = flying;
+  lastUpdate = motion.t;
+}
+
+void CatchScore::enter()
+{
+  streak = 0;
+}
+
+void CatchScore::onNotify( ImpactEvent &impact)
+{
+  if ( impact.impact.kind == IMPACT_CATCH ){
+    streak++;
+    if ( streak > best ) best = streak;
+  }
+  else { streak = 0; } //Dropped It
+  frisbeem._deferred.post( PRIORITY_REPORT, &sendScore, this );
+}
+
+bool GameSwitch::add(Game *game, EventBus &bus)
+{
+  if ( numGames >= MAX_GAMES ) return false;
+  _bus = &bus;
+  game -> subscribe( bus );
+  bus.enable( game, false ); //Paused Until Activated
+  _games[ numGames++ ] = game;
+  return true;
+}
+
+bool GameSwitch::activate(uint8_t index, bool on)
+{
+  if ( index >= numGames ) return false;
+  if ( active(index) == on ) return true;
+
+  Game *game = _games[index];
+  if ( on ){
+    activeMask |= (1 << index);
+    game -> enter();
+    game -> cost.nextRun = micros();
+    game -> cost.divider = 1; //Gets A Fresh Chance At Full Rate
+    game -> deliveryCost.divider = 1;
+    game -> deliveryCost.nextRun = micros();
+    _bus -> enable( game, true );
+    if ( game -> scripted ) frisbeem._scripts.start( game );
+  }
+  else {
+    activeMask &= ~(1 << index);
+    _bus -> enable( game, false );
+    if ( game -> scripted ) frisbeem._scripts.stop( game );
+    game -> leave();
+  }
+  return true;
+}
+
+bool GameSwitch::switchTo(uint8_t index)
+{
+  if ( index != NO_GAME && index >= numGames ) return false;
+  for (uint8_t i = 0; i < numGames; i++){
+    if ( i != index ) activate( i, false );
+  }
+  if ( index != NO_GAME ) activate( index, true );
+  return true;
+}
+
+void GameSwitch::update()
+{
+  if ( activeMask == 0 ) return;
+  unsigned long now = micros();
+  uint32_t spent = 0;
+  for (uint8_t k = 0; k < numGames; k++){
+    uint8_t i = (_next + k) % numGames;
+    Game *game = _games[i];
+    if ( !active(i) || game -> updateRate <= 0 ) continue;
+    if ( (long)(now - game -> cost.nextRun) < 0 ) continue; //Not Due
+
+    if ( spent >= frameBudget ){ //Out Of Time, This One Goes First Next Pass
+      game -> cost.deferred++;
+      _next = i;
+      return;
+    }
+
+    uint32_t t0 = micros();
+    game -> update();
+    uint32_t dt = micros() - t0;
+    spent += dt;
+    game -> cost.nextRun = t0 + (uint32_t)(1E6 / game -> updateRate) * game -> cost.divider;
+    game -> cost.account( dt, game -> updateBudget );
+  }
+  _next = (_next + 1) % numGames;
+}
+
+void GameCost::record(uint32_t spent, uint32_t budget)
+{
+  calls++;
+  lastMicros = spent;
+  avgMicros = calls == 1 ? spent : avgMicros - (avgMicros >> 3) + (spent >> 3);
+  if ( spent > maxMicros ) maxMicros = spent;
+  if ( spent > budget ) overruns++;
+}
+
+void GameCost::account(uint32_t spent, uint32_t budget)
+{
+  GameCost &c = *this;
+  record( spent, budget );
+
+  if ( spent > budget ){
+    c.good = 0;
+    if ( ++c.strikes < DEGRADE_STRIKES ) return;
+    c.strikes = 0;
+    if ( c.divider < MAX_DIVIDER ){ c.divider <<= 1; } //Half The Rate
+    else { //Still Too Slow At The Floor, Park It
+      c.suspends++;
+      c.nextRun += SUSPEND_MICROS;
+    }
+  }
+  else {
+    c.strikes = 0;
+    if ( c.divider > 1 && ++c.good >= RECOVER_CALLS ){
+      c.good = 0;
+      c.divider >>= 1;
+    }
+  }
+}
+
+void GameSwitch::resetCosts()
+{ //Counters Only, The Schedule & Back Off Stay
+  for (uint8_t i = 0; i < numGames; i++){
+    GameCost *costs[3] = { &_games[i] -> cost, &_games[i] -> deliveryCost, &_games[i] -> eventCost };
+    for (uint8_t k = 0; k < 3; k++){
+      unsigned long nextRun = costs[k] -> nextRun;
+      uint8_t divider = costs[k] -> divider;
+      costs[k] -> reset();
+      costs[k] -> nextRun = nextRun;
+      costs[k] -> divider = divider;
+    }
+  }
+}
@@ -1,11 +1,47 @@
 #include "application.h"
+
+#ifndef _INCL_GAMES
+#define _INCL_GAMES
+
 #include "observer.h"
+#include "eventbus.h"
+#include "scripts.h"
 
 //Predeclare
 //class Observer;
 class Event;
 class MotionEvent;
 class COMEvent;
+class ImpactEvent;
+class GestureEvent;
+
+#define DEGRADE_STRIKES 3  //Overruns in a row before the update rate is halved
+#define RECOVER_CALLS 32   //Calls in budget in a row before it's doubled again
+#define MAX_DIVIDER 16     //Past this the game gets suspended instead
+#define SUSPEND_MICROS 1000000
+
+//What A Game's update() Or Its Deliveries Have Been Costing
+struct GameCost
+{
+  uint32_t calls = 0;
+  uint32_t lastMicros = 0;
+  uint32_t avgMicros = 0;  //Running average, 1/8 weight to each new call
+  uint32_t maxMicros = 0;
+  uint32_t overruns = 0;   //Calls over updateBudget
+  uint32_t suspends = 0;   //Times it overran at MAX_DIVIDER & was parked for SUSPEND_MICROS
+  uint32_t deferred = 0;   //Times it was due but the frame's game budget was already spent, or a delivery skipped
+  uint8_t divider = 1;     //Effective rate is updateRate / divider, deliveries pass 1 in divider
+  uint8_t strikes = 0;
+  uint8_t good = 0;
+  uint8_t skip = 0;        //Deliveries since the last one let through
+  unsigned long nextRun = 0;
+
+  void reset() { *this = GameCost(); };
+  //One Call Took spent, Counters Only
+  void record(uint32_t spent, uint32_t budget);
+  //As record(), Then Overruns Halve The Rate, At The Floor It's Parked Past nextRun. Good Runs Win It Back
+  void account(uint32_t spent, uint32_t budget);
+};
 
 class Game: public Observer
 {
@@ -14,27 +50,138 @@ public:
   virtual void onNotify( Event &event){};
   virtual void onNotify( MotionEvent &motion){};
   virtual void onNotify( COMEvent &com){};
+  virtual void onNotify( ImpactEvent &impact){};
+  virtual void onNotify( GestureEvent &gesture){};
 
   //Important Methods
-  virtual void update(){};
+  virtual void update(){}; //Called At updateRate By GameSwitch While The Game Is Active
+  virtual void enter(){}; //Switched in, reset rounds & scores here
+  virtual void leave(){}; //Switched out
   virtual String name() {return "Game";};
+
+  //Hook The onNotify Overloads Up To The Bus
+  virtual void subscribe(EventBus &bus);
+  //update() Scheduling, 0 Means Never. Over updateBudget The Rate Backs Off (See GameSwitch)
+  float updateRate = 0; //Hz
+  uint32_t updateBudget = 200; //Microseconds Per Call
+  GameCost cost;
+
+  //Motion & Script Resumes Go Through Here, Timed Against deliveryBudget With The Same Back Off. Skipped
+  //Motion Is Folded Into The Next Delivery By The Bus, Skipped Resumes Are Held By The ScriptRunner
+  uint32_t deliveryBudget = 300; //Microseconds Per Delivery
+  GameCost deliveryCost;
+  template <typename E>
+  void deliver(E &event)
+  {
+    if ( !admit() ) return;
+    uint32_t t0 = micros();
+    onNotify( event );
+    delivered( t0 );
+  };
+  //Impacts & Gestures Only Happen Once, They Always Go Through. Timed Against deliveryBudget, Never Backed Off
+  GameCost eventCost;
+  template <typename E>
+  void deliverEvent(E &event)
+  {
+    uint32_t t0 = micros();
+    onNotify( event );
+    eventCost.record( micros() - t0, deliveryBudget );
+  };
+  bool runScript(ScriptFrame &f); //False when it was skipped
+  bool admit();                   //Not parked, & this delivery is the 1 in divider that gets through
+  void delivered(uint32_t t0);
+
+  //Motion Delivery, 0 Is Every Sample. Games That Only Need A Summary Should Ask For Less
+  float motionRate = 0;
+  uint8_t motionPolicy = COALESCE_LATEST;
+
+  //Scripted Games Run script() On The ScriptRunner Instead Of Taking Every MotionEvent
+  bool scripted = false;
+  bool wantsMotion = true; //Games that only care about impacts & gestures skip the motion stream
+  virtual void script(ScriptFrame &f){};
 };
 
 class Firework: public Game
 {
 public:
+  Firework() { scripted = true; };
   //Important Methods
   virtual void onNotify( Event &motion){};
-  virtual void onNotify( MotionEvent &motion);
+  virtual void script(ScriptFrame &f);
   virtual void update();
 
   //Peak Detection
-  //If the disk is spinning, check throwHeight against the currentMax
-  //If height is less than the maxHeight, and postMaxVelocity is negative
-  //Send Out A PeakThrow Signal That Lights An Animation & Plays a sound
-  float maxHeight;
-  bool isSpinning;
-  bool peakDetected;
+  //Once the disc is in flight, wait for the top of the throw
+  //If it climbed far enough, send out a PeakThrow signal that lights an animation & plays a sound
+  float minPeakHeight = 2;
+  unsigned long maxFlightTime = 5000000; //Give up on a flight that never peaks
 
   virtual String name() {return "Firework";};
 };
+
+//Revolutions Per Flight
+//Spin is smooth once the disc is released, so the bus's 50Hz mean of the samples in between is plenty
+class SpinCount: public Game
+{
+public:
+  SpinCount() { motionRate = 50; motionPolicy = COALESCE_MEAN; };
+  virtual void onNotify( Event &event){};
+  virtual void onNotify( MotionEvent &motion);
+  virtual void enter();
+
+  float spins = 0;
+  float best = 0;
+  bool inFlight = false;
+  unsigned long lastUpdate = 0;
+
+  virtual String name() {return "SpinCount";};
+};
+
+//Streak Of Catches Without A Drop
+class CatchScore: public Game
+{
+public:
+  CatchScore() { wantsMotion = false; };
+  virtual void onNotify( Event &event){};
+  virtual void onNotify( ImpactEvent &impact);
+  virtual void enter();
+
+  uint16_t streak = 0;
+  uint16_t best = 0;
+
+  virtual String name() {return "CatchScore";};
+};
+
+#define MAX_GAMES 4
+#define NO_GAME 0xFF
+
+//Game Runtime
+//Every game lives in static storage & is subscribed once at startup, paused. Activating a game resumes its
+//handlers, so changing the mix never allocates or rebuilds the bus. Any number can be active together
+//
+//update() runs from the physics loop, each active game at its own updateRate, timed against its updateBudget.
+//A game that keeps overrunning gets its rate halved, down to updateRate / MAX_DIVIDER, then suspended for a bit.
+//All games together get frameBudget per pass; whoever doesn't fit waits for the next pass, round robin
+class GameSwitch
+{
+public:
+  bool add(Game *game, EventBus &bus);
+  bool activate(uint8_t index, bool on);
+  bool switchTo(uint8_t index); //Only this one active, NO_GAME to run none
+  void update();
+  void resetCosts();
+
+  bool active(uint8_t index) { return index < numGames && (activeMask & (1 << index)); };
+  Game* game(uint8_t index) { return index < numGames ? _games[index] : NULL; };
+
+  uint8_t activeMask = 0;
+  uint8_t numGames = 0;
+  uint32_t frameBudget = 400; //Microseconds Per Pass, All Games
+
+private:
+  Game *_games[MAX_GAMES];
+  EventBus *_bus = NULL;
+  uint8_t _next = 0; //First game to look at next pass
+};
+
+#endif
@@ -0,0 +1,266 @@
+#include "gestures.h"
+#import "event.h"
+
+#define DTW_INF 0x3FFFFFFF
+
+//Quantization Per Channel: A In g, G In deg/s
+static const float GESTURE_SCALE[GESTURE_CHANNELS] = { 32.0f, 32.0f, 32.0f / 180.0f };
+
+static inline int8_t quantize(float v)
+{
+  int32_t q = (int32_t)(v >= 0 ? v + 0.5f : v - 0.5f);
+  if ( q > 127 ) q = 127;
+  if ( q < -127 ) q = -127;
+  return (int8_t)q;
+}
+
+bool GestureEngine::update(MotionEvent &motion)
+{
+  if ( !enabled ) return false;
+  if ( _sumCount == 0 ){ _stepStart = motion.t; }
+
+  //Box Filter Down To One Step
+  _sum[0] += motion.A.z;
+  _sum[1] += sqrt(motion.A.x * motion.A.x + motion.A.y * motion.A.y);
+  _sum[2] += motion.G.z;
+  _sumCount++;
+  if ( motion.t - _stepStart < stepMicros ) return false;
+
+  pushStep(motion.t);
+  if ( recording() || _filled < GESTURE_LEN ) return false;
+  if ( !recognize(motion.t) ) return false;
+  //Make The Window Refill So The Same Motion Isn't Recognized Twice
+  _filled = 0;
+  return true;
+}
+
+void GestureEngine::pushStep(unsigned long t)
+{
+  int8_t *slot = _window[_head];
+  for (int ch = 0; ch < GESTURE_CHANNELS; ch++){
+    slot[ch] = quantize( _sum[ch] / _sumCount * GESTURE_SCALE[ch] );
+    _sum[ch] = 0;
+  }
+  _sumCount = 0;
+  _head = (_head + 1) % GESTURE_LEN;
+  if ( _filled < GESTURE_LEN ) _filled++;
+  steps++;
+
+  //Recording Just Lets The Window Fill Up With The Gesture
+  if ( recording() && ++_recordCount >= GESTURE_LEN ){
+    GestureTemplate &g = templates[_recordSlot];
+    for (int i = 0; i < GESTURE_LEN; i++){
+      for (int ch = 0; ch < GESTURE_CHANNELS; ch++){ g.data[i][ch] = query(i, ch); }
+    }
+    g.threshold = autoThreshold(g);
+    g.valid = true;
+    buildEnvelope(g);
+    _recordSlot = -1;
+  }
+}
+
+//Oldest First
+int8_t &GestureEngine::query(int i, int ch)
+{
+  return _window[ (_head + i) % GESTURE_LEN ][ch];
+}
+
+bool GestureEngine::recognize(unsigned long t)
+{
+  int best = -1;
+  int32_t bestDistance = DTW_INF;
+  for (int n = 0; n < MAX_GESTURES; n++)
+  {
+    GestureTemplate &g = templates[n];
+    if ( !g.valid ) continue;
+    int32_t limit = g.threshold < bestDistance ? g.threshold : bestDistance;
+
+    //Cheap Bound First, Most Templates Stop Here
+    if ( lowerBound(g, limit) > limit ){ lbPruned++; continue; }
+
+    int32_t d = dtw(g, limit);
+    if ( d > limit ){ dtwAbandoned++; continue; }
+    best = n;
+    bestDistance = d;
+  }
+  if ( best < 0 ) return false;
+
+  lastGesture = best;
+  lastDistance = bestDistance;
+  lastTime = t;
+  return true;
+}
+
+//LB_Keogh: Distance From The Query To The Template's Warping Envelope, Never More Than The DTW Distance
+int32_t GestureEngine::lowerBound(GestureTemplate &g, int32_t limit)
+{
+  int32_t lb = 0;
+  for (int i = 0; i < GESTURE_LEN; i++){
+    for (int ch = 0; ch < GESTURE_CHANNELS; ch++){
+      int8_t q = query(i, ch);
+      if ( q > g.upper[i][ch] ){ lb += q - g.upper[i][ch]; }
+      else if ( q < g.lower[i][ch] ){ lb += g.lower[i][ch] - q; }
+    }
+    if ( lb > limit ) return lb;
+  }
+  return lb;
+}
+
+//Banded DTW With L1 Step Cost, Gives Up As Soon As A Whole Row Is Over limit
+int32_t GestureEngine::dtw(GestureTemplate &g, int32_t limit)
+{
+  dtwRun++;
+  int32_t *prev = _rowA, *cur = _rowB;
+  prev[0] = 0;
+  for (int j = 1; j <= GESTURE_LEN; j++){ prev[j] = DTW_INF; }
+
+  for (int i = 1; i <= GESTURE_LEN; i++)
+  {
+    int jlo = i - GESTURE_BAND < 1 ? 1 : i - GESTURE_BAND;
+    int jhi = i + GESTURE_BAND > GESTURE_LEN ? GESTURE_LEN : i + GESTURE_BAND;
+    cur[jlo - 1] = DTW_INF;
+    if ( jhi < GESTURE_LEN ){ cur[jhi + 1] = DTW_INF; }
+    int32_t rowMin = DTW_INF;
+    for (int j = jlo; j <= jhi; j++)
+    {
+      int32_t cost = 0;
+      for (int ch = 0; ch < GESTURE_CHANNELS; ch++){ cost += abs( query(i - 1, ch) - g.data[j - 1][ch] ); }
+      int32_t step = prev[j - 1];
+      if ( prev[j] < step ) step = prev[j];
+      if ( cur[j - 1] < step ) step = cur[j - 1];
+      cur[j] = cost + step;
+      if ( cur[j] < rowMin ) rowMin = cur[j];
+    }
+    if ( rowMin > limit ) return rowMin;
+    int32_t *swap = prev; prev = cur; cur = swap;
+  }
+  return prev[GESTURE_LEN];
+}
+
+void GestureEngine::buildEnvelope(GestureTemplate &g)
+{
+  for (int i = 0; i < GESTURE_LEN; i++){
+    int lo = i - GESTURE_BAND < 0 ? 0 : i - GESTURE_BAND;
+    int hi = i + GESTURE_BAND >= GESTURE_LEN ? GESTURE_LEN - 1 : i + GESTURE_BAND;
+    for (int ch = 0; ch < GESTURE_CHANNELS; ch++){
+      int8_t u = -127, l = 127;
+      for (int k = lo; k <= hi; k++){
+        if ( g.data[k][ch] > u ) u = g.data[k][ch];
+        if ( g.data[k][ch] < l ) l = g.data[k][ch];
+      }
+      g.upper[i][ch] = u;
+      g.lower[i][ch] = l;
+    }
+  }
+}
+
+void GestureEngine::loadDefaults()
+{
+  for (int n = 0; n < MAX_GESTURES; n++){ templates[n].valid = false; }
+  for (int i = 0; i < GESTURE_LEN; i++)
+  {
+    //Flip: Face Up To Face Down Through A Sideways Swing
+    int8_t *f = templates[GESTURE_FLIP].data[i];
+    int ramp = i - 12;
+    f[0] = ramp < 0 ? 32 : (ramp > 8 ? -32 : 32 - ramp * 8);
+    f[1] = (ramp >= 0 && ramp <= 8) ? 24 : 0;
+    f[2] = 0;
+
+    //Shake: Side To Side, |A.xy| Peaks Twice A Cycle
+    int8_t *s = templates[GESTURE_SHAKE].data[i];
+    s[0] = 32;
+    s[1] = (i / 2) % 2 ? 8 : 48;
+    s[2] = 0;
+
+    //Double Tap: Two Short Knocks Through The Face
+    int8_t *d = templates[GESTURE_DOUBLE_TAP].data[i];
+    d[0] = (i == 10 || i == 18) ? 56 : 32; //Knocks Are Mostly Averaged Away Within A Step
+    d[1] = 0;
+    d[2] = 0;
+
+    //Twist: Two Back & Forth Turns About The Spin Axis
+    int8_t *t = templates[GESTURE_TWIST].data[i];
+    t[0] = 32;
+    t[1] = 0;
+    t[2] = quantize( 64.0f * sin( 2.0f * 2.0f * M_PI * i / GESTURE_LEN ) );
+  }
+  for (int n = GESTURE_FLIP; n <= GESTURE_TWIST; n++){
+    templates[n].threshold = autoThreshold(templates[n]);
+    templates[n].valid = true;
+    buildEnvelope(templates[n]);
+  }
+
+  for (int n = 0; n < MAX_GESTURES; n++){ actions[n] = ACTION_NONE; }
+  actions[GESTURE_FLIP] = ACTION_LIGHTS;
+  actions[GESTURE_SHAKE] = ACTION_CALIBRATE;
+}
+
+bool GestureEngine::setAction(uint8_t slot, uint8_t action)
+{
+  if ( slot >= MAX_GESTURES || action >= NUM_GESTURE_ACTIONS ) return false;
+  actions[slot] = action;
+  return true;
+}
+
+//Half Way Between A Perfect Match And Sitting Still Face Up, So Resting Never Matches
+uint16_t GestureEngine::autoThreshold(GestureTemplate &g)
+{
+  static const int8_t still[GESTURE_CHANNELS] = { 32, 0, 0 };
+  int32_t d = 0;
+  for (int i = 0; i < GESTURE_LEN; i++){
+    for (int ch = 0; ch < GESTURE_CHANNELS; ch++){ d += abs( g.data[i][ch] - still[ch] ); }
+  }
+  d /= 2;
+  return d < defaultThreshold ? d : defaultThreshold;
+}
+
+void GestureEngine::record(uint8_t slot)
+{
+  if ( slot >= MAX_GESTURES ) return;
+  templates[slot].valid = false;
+  _recordSlot = slot;
+  _recordCount = 0;
+}
+
+void GestureEngine::clear(uint8_t slot)
+{
+  if ( slot < MAX_GESTURES ){ templates[slot].valid = false; }
+}
+
+//Only The Template Data Goes To EEPROM, Envelopes Are Rebuilt On Load
+void GestureEngine::save()
+{
+  int addr = GESTURE_EEPROM_ADDR;
+  EEPROM.write(addr++, GESTURE_EEPROM_MAGIC);
+  for (int n = 0; n < MAX_GESTURES; n++){
+    GestureTemplate &g = templates[n];
+    EEPROM.write(addr++, g.valid);
+    EEPROM.put(addr, g.threshold); addr += sizeof(g.threshold);
+    EEPROM.put(addr, g.data); addr += sizeof(g.data);
+  }
+
+  //Actions Have Their Own Block, Templates Saved Before They Existed Still Load
+  addr = GESTURE_ACTION_EEPROM_ADDR;
+  EEPROM.write(addr++, GESTURE_ACTION_EEPROM_MAGIC);
+  EEPROM.put(addr, actions);
+}
+
+void GestureEngine::load()
+{
+  int addr = GESTURE_EEPROM_ADDR;
+  if ( EEPROM.read(addr++) != GESTURE_EEPROM_MAGIC ) return; //Nothing Saved Yet
+  for (int n = 0; n < MAX_GESTURES; n++){
+    GestureTemplate &g = templates[n];
+    g.valid = EEPROM.read(addr++) == 1;
+    EEPROM.get(addr, g.threshold); addr += sizeof(g.threshold);
+    EEPROM.get(addr, g.data); addr += sizeof(g.data);
+    if ( g.valid ){ buildEnvelope(g); }
+  }
+
+  addr = GESTURE_ACTION_EEPROM_ADDR;
+  if ( EEPROM.read(addr++) != GESTURE_ACTION_EEPROM_MAGIC ) return; //Keep The Defaults
+  EEPROM.get(addr, actions);
+  for (int n = 0; n < MAX_GESTURES; n++){
+    if ( actions[n] >= NUM_GESTURE_ACTIONS ) actions[n] = ACTION_NONE;
+  }
+}
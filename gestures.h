@@ -0,0 +1,106 @@
+#include "application.h"
+
+#ifndef _INCL_GESTURES
+#define _INCL_GESTURES
+
+class MotionEvent;
+
+#define GESTURE_LEN 32         //Steps In The Window & In Each Template
+#define GESTURE_CHANNELS 3     //A.z, |A.xy|, G.z
+#define GESTURE_BAND 4         //DTW warping band (steps)
+#define MAX_GESTURES 6         //Template Slots
+#define GESTURE_EEPROM_ADDR 0
+#define GESTURE_EEPROM_MAGIC 0xB3
+#define GESTURE_ACTION_EEPROM_ADDR 640 //Past the templates, 1 + MAX_GESTURES * 99 bytes
+#define GESTURE_ACTION_EEPROM_MAGIC 0xA1
+
+//Built In Slots, The Rest Are Free For User Recordings
+enum GestureSlots {
+  GESTURE_FLIP = 0,
+  GESTURE_SHAKE,
+  GESTURE_DOUBLE_TAP,
+  GESTURE_TWIST,
+};
+
+//What A Recognized Gesture Does, See Frisbeem::onGesture
+enum GestureActions {
+  ACTION_NONE = 0,
+  ACTION_LIGHTS,     //Strip on/off, like PWR ONN/OFF
+  ACTION_CALIBRATE,  //Same as TEL CAL, hold it still
+  ACTION_POV,        //POV on/off
+  ACTION_NEXT_GAME,  //Play only the next game in the list
+  NUM_GESTURE_ACTIONS
+};
+
+//Quantized Template Plus Its LB_Keogh Envelope
+struct GestureTemplate {
+  bool valid;
+  uint16_t threshold;                            //Max DTW distance to count as a match
+  int8_t data[GESTURE_LEN][GESTURE_CHANNELS];
+  int8_t upper[GESTURE_LEN][GESTURE_CHANNELS];
+  int8_t lower[GESTURE_LEN][GESTURE_CHANNELS];
+};
+
+//Gesture Recognition Over A Sliding Window Of Downsampled Motion
+//Motion is box filtered down to one step every stepMicros and quantized to int8. On each step every template
+//is first checked against its LB_Keogh lower bound, and only survivors get a banded DTW that abandons as soon
+//as a row can't beat the best match so far. All integer math, all storage preallocated
+class GestureEngine
+{
+public:
+  //Parameters
+  bool enabled = true;
+  unsigned long stepMicros = 25000;       //40Hz steps, window spans 0.8s
+  uint16_t defaultThreshold = 600;        //Cap on the per template threshold, see autoThreshold
+
+  GestureTemplate templates[MAX_GESTURES];
+  uint8_t actions[MAX_GESTURES];          //GestureActions by slot, saved with the templates
+
+  //Output
+  uint8_t lastGesture = 0;
+  uint16_t lastDistance = 0;
+  unsigned long lastTime = 0;
+
+  //Stats
+  uint32_t steps = 0, lbPruned = 0, dtwAbandoned = 0, dtwRun = 0;
+
+  //Feed Every Sample, Returns True When A Gesture Was Recognized
+  bool update(MotionEvent &motion);
+
+  //Template Management
+  void record(uint8_t slot);   //Next GESTURE_LEN steps become the template
+  bool recording() { return _recordSlot >= 0; };
+  void clear(uint8_t slot);
+  void save();
+  void load();
+  void loadDefaults();         //Synthetic flip, shake, double tap & twist, & their actions
+  bool setAction(uint8_t slot, uint8_t action);
+
+private:
+  void pushStep(unsigned long t);
+  bool recognize(unsigned long t);
+  int8_t &query(int i, int ch);
+  int32_t lowerBound(GestureTemplate &g, int32_t limit);
+  int32_t dtw(GestureTemplate &g, int32_t limit);
+  void buildEnvelope(GestureTemplate &g);
+  uint16_t autoThreshold(GestureTemplate &g);
+
+  //Downsampling Accumulators
+  float _sum[GESTURE_CHANNELS] = {0, 0, 0};
+  uint16_t _sumCount = 0;
+  unsigned long _stepStart = 0;
+
+  //Query Window (Ring)
+  int8_t _window[GESTURE_LEN][GESTURE_CHANNELS];
+  uint8_t _head = 0;
+  uint8_t _filled = 0;
+
+  //DTW Rows
+  int32_t _rowA[GESTURE_LEN + 1];
+  int32_t _rowB[GESTURE_LEN + 1];
+
+  int _recordSlot = -1;
+  uint8_t _recordCount = 0;
+};
+
+#endif
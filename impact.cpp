@@ -0,0 +1,54 @@
+#include "impact.h"
+
+//Kept Local So We Don't Depend On Which min/max The Platform Headers Leave Defined
+static inline int32_t larger(int32_t a, int32_t b){ return a > b ? a : b; }
+
+void ImpactDetector::setScale(float aRes, float gRes)
+{
+  _aRes = aRes;
+  _jerkCounts = jerkG / aRes;
+  _peakCounts = peakG / aRes;
+  _catchMaxCounts = catchMaxG / aRes;
+  catchSpinCounts = catchSpinDps / gRes;
+}
+
+bool ImpactDetector::update(int16_t *accel, int16_t gyroZ, unsigned long t)
+{
+  int16_t *prev = _ring[ (_head - 1) & (IMPACT_WINDOW - 1) ];
+  int32_t jerk = abs(accel[0] - prev[0]) + abs(accel[1] - prev[1]) + abs(accel[2] - prev[2]);
+  int32_t peak = larger( abs(accel[0]), larger( abs(accel[1]), abs(accel[2]) ) );
+
+  int16_t *slot = _ring[_head];
+  slot[0] = accel[0]; slot[1] = accel[1]; slot[2] = accel[2];
+  _head = (_head + 1) & (IMPACT_WINDOW - 1);
+
+  if ( !_primed ){ _primed = true; return false; } //No Previous Sample To Difference Against
+  if ( jerk < _jerkCounts || peak < _peakCounts ) return false;
+  if ( t - _lastImpact < holdoffMicros ) return false;
+
+  _lastImpact = t;
+  classify(gyroZ, t);
+  return true;
+}
+
+void ImpactDetector::classify(int16_t gyroZ, unsigned long t)
+{
+  //Which Way Did The Window Get Hit Hardest: Through The Face (z) Or The Rim (x/y)
+  int32_t face = 0, rim = 0;
+  for (int i = 0; i < IMPACT_WINDOW; i++){
+    int32_t z = abs(_ring[i][2]);
+    int32_t xy = larger( abs(_ring[i][0]), abs(_ring[i][1]) );
+    if ( z > face ) face = z;
+    if ( xy > rim ) rim = xy;
+  }
+  int32_t peak = larger(face, rim);
+
+  if ( face >= rim ){ last.kind = IMPACT_GROUND; }
+  else if ( peak < _catchMaxCounts && abs(gyroZ) > catchSpinCounts ){ last.kind = IMPACT_CATCH; }
+  else { last.kind = IMPACT_WALL; }
+
+  last.peakG = peak * _aRes;
+  last.t = t;
+  count++;
+  pending = true;
+}
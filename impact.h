@@ -0,0 +1,55 @@
+#include "application.h"
+
+#ifndef _INCL_IMPACT
+#define _INCL_IMPACT
+
+#define IMPACT_WINDOW 8 //Raw Samples Kept For Classification (Power Of 2)
+
+enum ImpactKind {
+  IMPACT_CATCH = 0,
+  IMPACT_GROUND,
+  IMPACT_WALL,
+};
+
+struct ImpactRecord {
+  uint8_t kind;
+  float peakG;          //Largest axis reading in the window, g
+  unsigned long t;      //micros() of the sample that tripped the detector
+};
+
+//Catch & Impact Detector On Raw Accelerometer Counts
+//Runs on every raw sample with a handful of integer ops: L1 jerk between consecutive samples plus the
+//largest axis magnitude. Only when both trip do we look back over the small ring to classify the hit
+class ImpactDetector
+{
+public:
+  //Parameters In g (Converted To Counts By setScale)
+  float jerkG = 2.0;             //L1 change between samples
+  float peakG = 3.0;             //Largest axis reading
+  float catchMaxG = 6.0;         //Rim hits softer than this while spinning are catches
+  int16_t catchSpinCounts = 0;   //|gyro z| counts above which the disc counts as spinning (set by setScale)
+  float catchSpinDps = 200;
+  unsigned long holdoffMicros = 50000; //Ignore the ringing after a hit
+
+  //Output
+  bool pending = false;          //Set on a new impact, cleared by whoever consumes it
+  ImpactRecord last;
+  uint32_t count = 0;
+
+  void setScale(float aRes, float gRes);
+  bool update(int16_t *accel, int16_t gyroZ, unsigned long t);
+
+private:
+  void classify(int16_t gyroZ, unsigned long t);
+
+  int16_t _ring[IMPACT_WINDOW][3];
+  uint8_t _head = 0;
+  int32_t _jerkCounts = 0x7FFFFFFF;
+  int32_t _peakCounts = 0x7FFFFFFF;
+  int32_t _catchMaxCounts = 0x7FFFFFFF;
+  float _aRes = 0;
+  unsigned long _lastImpact = 0;
+  bool _primed = false;
+};
+
+#endif
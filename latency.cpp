@@ -0,0 +1,43 @@
+#include "latency.h"
+
+void LatencyHistogram::reset()
+{
+  for (uint8_t i = 0; i < LATENCY_BUCKETS; i++){ buckets[i] = 0; }
+  count = 0;
+  maxMicros = 0;
+  lastMicros = 0;
+}
+
+void LatencyHistogram::record(uint32_t micros)
+{
+  uint8_t bucket = micros == 0 ? 0 : 31 - __builtin_clz( micros );
+  if ( bucket >= LATENCY_BUCKETS ) bucket = LATENCY_BUCKETS - 1;
+  buckets[bucket]++;
+  count++;
+  lastMicros = micros;
+  if ( micros > maxMicros ) maxMicros = micros;
+}
+
+uint32_t LatencyHistogram::percentile(uint8_t pct)
+{
+  if ( count == 0 ) return 0;
+  uint32_t target = ( (uint64_t)count * pct + 99 ) / 100;
+  uint32_t seen = 0;
+  for (uint8_t i = 0; i < LATENCY_BUCKETS; i++){
+    seen += buckets[i];
+    if ( seen >= target ) return i == LATENCY_BUCKETS - 1 ? maxMicros : ( 2UL << i ) - 1;
+  }
+  return maxMicros;
+}
+
+const char* LatencyTracker::name(uint8_t stage)
+{
+  switch (stage)
+  {
+    case LAT_FUSION: return "FUS";
+    case LAT_EVENT: return "EVT";
+    case LAT_WIRE: return "WIR";
+    case LAT_LED: return "LED";
+  }
+  return "???";
+}
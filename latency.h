@@ -0,0 +1,46 @@
+#include "application.h"
+
+#ifndef _INCL_LATENCY
+#define _INCL_LATENCY
+
+#define LATENCY_BUCKETS 20 //Bucket i holds [2^i, 2^(i+1)) microseconds, last one catches everything above
+
+//How Far Data Has Come From The Sensor Sample It Was Built From
+enum LatencyStage {
+  LAT_FUSION = 0, //Capture -> attitude & position updated
+  LAT_EVENT,      //Capture -> MotionEvent dispatched to every subscriber
+  LAT_WIRE,       //Capture -> telemetry frame handed to the TCP server
+  LAT_LED,        //Capture -> LED frame latched into the strip
+  NUM_LATENCY_STAGES
+};
+
+//Log2 Bucket Histogram
+//record() is a count-leading-zeros & an increment, nothing is formatted until someone asks over COM
+class LatencyHistogram
+{
+public:
+  LatencyHistogram() { reset(); };
+
+  void record(uint32_t micros);
+  void reset();
+  uint32_t percentile(uint8_t pct); //Upper edge of the bucket the percentile falls in
+
+  uint32_t buckets[LATENCY_BUCKETS];
+  uint32_t count;
+  uint32_t maxMicros;
+  uint32_t lastMicros;
+};
+
+//Every Raw Sample Gets A Sequence Number & Capture Time In The MPU. Things Built From It Carry Both Along
+//so the stage they reach can be measured against the capture
+class LatencyTracker
+{
+public:
+  void record(uint8_t stage, unsigned long captured) { stages[stage].record( micros() - captured ); };
+  void reset() { for (uint8_t i = 0; i < NUM_LATENCY_STAGES; i++){ stages[i].reset(); } };
+  const char* name(uint8_t stage);
+
+  LatencyHistogram stages[NUM_LATENCY_STAGES];
+};
+
+#endif
@@ -11,36 +11,68 @@ void Lights::initlaize()
   colorWipe( wheel( 255 ),20);
   _strip.show();
   delay(100);
+  invalidate();
 }
 
 void Lights::update(uint8_t wait)
-{
-  if (frisbeem._motionState.stateNow()->_motionData -> sleepModeActivated || !_on){
-    off();
-    refresh();
-    delay(250);
+{ //Work Out What The Frame Should Be First, Only Draw It If It's Not What's Showing
+  if ( frisbeem._pov.enabled ){ //POV Owns The Strip, Redraw When It Lets Go
+    invalidate();
+    return;
+  }
+  uint8_t pattern = PATTERN_SOLID;
+  uint8_t value = 0;
+  if ( !frisbeem._power.lightsOn() || !_on ){ //Loop Pacing Comes From The Power Profile
+    pattern = PATTERN_OFF;
   }
   else{ //Do Da Lights
-    frisbeem._com.log("State Now");
-    frisbeem._com.log( frisbeem._motionState.stateNow() -> type() );
-    if ( frisbeem._motionState.currentState == MotionSwitch::REST){
-        frisbeem._com.log("Case Rest");
-        blue();
-    }
-    else if ( frisbeem._motionState.currentState == MotionSwitch::SPIN){
-        frisbeem._com.log("Case Spin");
-        green();
-    }
-    else if ( frisbeem._motionState.currentState == MotionSwitch::MOTION) {
-        frisbeem._com.log("Case Motion");
-        orange();
-    }
-    else {
-        frisbeem._com.log("Default");
-        red();
+    switch ( frisbeem._motionState.currentState ){
+      case MotionSwitch::REST:
+      case MotionSwitch::LANDED:
+        if ( frisbeem._session.numPeers > 0 && frisbeem._session.synced() ){
+          //Linked Discs Turn The Wheel Together Off The Session Clock
+          pattern = PATTERN_RAINBOW;
+          value = (uint64_t) frisbeem._session.beat( wheelPeriod ) * 256 / wheelPeriod;
+        }
+        else { value = 255; } //Blue
+        break;
+      case MotionSwitch::SPIN:
+      case MotionSwitch::RELEASE:
+      case MotionSwitch::FLIGHT:
+        value = 60; //Green
+        break;
+      case MotionSwitch::MOTION:
+      case MotionSwitch::CATCH:
+        value = 200; //Orange
+        break;
+      default:
+        value = 180; //Red
+        break;
     }
-    refresh();
   }
+
+  uint32_t key = frameKey( pattern, value );
+  if ( !_dirty && key == _shownKey ){
+    framesSkipped++;
+    return;
+  }
+
+  frameSeq = frisbeem._mpu.sampleSeq;
+  frameCaptured = frisbeem._mpu.sampleTime;
+  switch ( pattern ){
+    case PATTERN_OFF: off(); break;
+    case PATTERN_RAINBOW: whl = value; rainbow( 0 ); break;
+    default: colorAll( wheel( value ) ); break;
+  }
+  refresh();
+  _shownKey = key;
+  _dirty = false;
+  framesDrawn++;
+}
+
+uint32_t Lights::frameKey(uint8_t pattern, uint8_t value)
+{ //Brightness Is Applied In show(), So It's Part Of The Frame Too
+  return ((uint32_t) pattern << 16) | ((uint32_t) value << 8) | _strip.getBrightness();
 }
 
 void Lights::refresh(){
@@ -49,6 +81,7 @@ void Lights::refresh(){
    //technically speaking
    _strip.show();
   }
+  frisbeem._latency.record( LAT_LED, frameCaptured );
 }
 
 // Cool and useful color functions
@@ -116,6 +149,8 @@ void Lights::colorWipe(uint32_t c, uint8_t wait) {
     delay(wait);
     _strip.show();
   }
+  invalidate();
+  frisbeem._latency.record( LAT_LED, frameCaptured );
 }
 
 
@@ -134,37 +169,6 @@ uint32_t Lights::wheel(byte WheelPos) {
   }
 }
 
-void Lights::orange() {
-  uint16_t i, j;
-
-  for(i=0; i<_strip.numPixels(); i++) {
-      _strip.setPixelColor(i, wheel(200));
-  }
-}
-
-void Lights::blue() {
-  uint16_t i, j;
-
-  for(i=0; i<_strip.numPixels(); i++) {
-      _strip.setPixelColor(i, wheel(255));
-  }
-}
-
-void Lights::green() {
-  uint16_t i, j;
-
-  for(i=0; i<_strip.numPixels(); i++) {
-      _strip.setPixelColor(i, wheel(60));
-  }
-}
-
-void Lights::red() {
-  uint16_t i, j;
-
-  for(i=0; i<_strip.numPixels(); i++) {
-      _strip.setPixelColor(i, wheel(180));
-  }
-}
 void Lights::off() {
   uint16_t i, j;
 
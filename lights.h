@@ -4,6 +4,13 @@
 #define DOTSTAR_GRB (1 | (0 << 2) | (2 << 4))
 #define NUM_LED 50
 
+//What A Frame Is Drawn From
+enum LightPattern {
+  PATTERN_OFF = 0,
+  PATTERN_SOLID,   //Every pixel one wheel colour
+  PATTERN_RAINBOW  //Wheel across the strip, turned by whl
+};
+
 class Lights
 { //In Which We Light The World
 public:
@@ -18,6 +25,18 @@ public:
 
   //Counting variables
   uint8_t whl;
+  uint32_t wheelPeriod = 4000000; //Micros once round the wheel when resting in a session
+
+  //Raw Sample The Current Frame Was Built From
+  uint32_t frameSeq = 0;
+  unsigned long frameCaptured = 0;
+
+  //Frame Tracking
+  //Each frame is summed up in a key (pattern, colour, brightness). If it matches the frame already on the
+  //strip, update() skips drawing & the interrupts-off show() and the loop goes straight back to sampling
+  uint32_t framesDrawn = 0;
+  uint32_t framesSkipped = 0;
+  void invalidate() { _dirty = true; }; //Something wrote the strip behind update()'s back
 
   //Important Funcitons
   virtual void update(uint8_t wait);
@@ -31,13 +50,14 @@ public:
   void quarters(uint32_t c,uint32_t c2, uint8_t offset);
 
   //Solid Colors
-  virtual void orange();
-  virtual void blue();
-  virtual void green();
-  virtual void red();
   virtual void off();
 
   //Utility Functions
   uint32_t wheel( byte WheelPos );
 
+private:
+  uint32_t frameKey(uint8_t pattern, uint8_t value);
+  uint32_t _shownKey = 0;
+  bool _dirty = true;
+
 };
@@ -0,0 +1,190 @@
+#include "motionhistory.h"
+#import "event.h"
+
+void MotionHistory::reset()
+{
+  _seq = 0;
+  _count = 0;
+  for (uint8_t i = 0; i < _numWindows; i++){ resetWindow( _windows[i] ); }
+}
+
+void MotionHistory::resetWindow(Window &w)
+{
+  w.tail = _seq + 1;
+  w.sum = 0;
+  w.minQ.head = 0; w.minQ.count = 0;
+  w.maxQ.head = 0; w.maxQ.count = 0;
+}
+
+int8_t MotionHistory::track(uint8_t channel, unsigned long spanMicros)
+{
+  if ( _numWindows >= MAX_HISTORY_WINDOWS || channel >= CH_COUNT ) return -1;
+  Window &w = _windows[_numWindows];
+  w.channel = channel;
+  w.span = spanMicros;
+  resetWindow( w );
+
+  //Start From The Stored Samples That Fall Inside The Span, Once, So The Window Answers Straight Away
+  if ( _count > 0 ){
+    uint32_t oldest = _seq - _count + 1;
+    unsigned long t = _samples[ _seq & (HISTORY_SIZE - 1) ].t;
+    w.tail = _seq;
+    while ( w.tail > oldest && t - _samples[ (w.tail - 1) & (HISTORY_SIZE - 1) ].t <= spanMicros ){ w.tail--; }
+    for (uint32_t n = w.tail; n <= _seq; n++){
+      w.sum += value( n, channel );
+      push( w.minQ, n, channel, false );
+      push( w.maxQ, n, channel, true );
+    }
+  }
+  return _numWindows++;
+}
+
+int8_t MotionHistory::find(uint8_t channel, unsigned long spanMicros)
+{
+  for (uint8_t i = 0; i < _numWindows; i++){
+    if ( _windows[i].channel == channel && _windows[i].span == spanMicros ) return i;
+  }
+  return -1;
+}
+
+void MotionHistory::record(MotionEvent &motion)
+{
+  if ( _count > 0 && motion.sampleSeq == _lastSampleSeq ) return; //Nothing New From The MPU
+  _lastSampleSeq = motion.sampleSeq;
+  uint32_t seq = _seq + 1;
+
+  //The Slot We're About To Write Drops Out Of Every Window First
+  for (uint8_t i = 0; i < _numWindows; i++){
+    Window &w = _windows[i];
+    if ( _count == HISTORY_SIZE && w.tail == seq - HISTORY_SIZE ){
+      w.sum -= value( w.tail, w.channel );
+      w.tail++;
+      expire( w.minQ, w.tail );
+      expire( w.maxQ, w.tail );
+    }
+  }
+
+  //Store The Sample
+  HistorySample &s = _samples[ seq & (HISTORY_SIZE - 1) ];
+  s.seq = seq;
+  s.t = motion.t;
+  for (uint8_t c = 0; c < CH_COUNT; c++){ s.value[c] = channelValue( motion, c ); }
+  _seq = seq;
+  if ( _count < HISTORY_SIZE ) _count++;
+
+  //Slide The Windows Forward
+  for (uint8_t i = 0; i < _numWindows; i++){
+    Window &w = _windows[i];
+    w.sum += s.value[w.channel];
+    while ( w.tail < seq && s.t - _samples[ w.tail & (HISTORY_SIZE - 1) ].t > w.span ){
+      w.sum -= value( w.tail, w.channel );
+      w.tail++;
+    }
+    //Rebuild The Sum Once Per Lap So Float Error Can't Build Up
+    if ( (seq & (HISTORY_SIZE - 1)) == 0 ){
+      w.sum = 0;
+      for (uint32_t n = w.tail; n <= seq; n++){ w.sum += value( n, w.channel ); }
+    }
+    push( w.minQ, seq, w.channel, false );
+    push( w.maxQ, seq, w.channel, true );
+    expire( w.minQ, w.tail );
+    expire( w.maxQ, w.tail );
+  }
+}
+
+void MotionHistory::push(ExtremeQueue &q, uint32_t seq, uint8_t channel, bool maximum)
+{ //Anything Beaten By The New Value Can Never Be The Extreme Again
+  float v = value( seq, channel );
+  while ( q.count > 0 ){
+    float back = _samples[ q.slot[ (q.head + q.count - 1) & (HISTORY_SIZE - 1) ] ].value[channel];
+    if ( maximum ? back > v : back < v ) break;
+    q.count--;
+  }
+  q.slot[ (q.head + q.count) & (HISTORY_SIZE - 1) ] = seq & (HISTORY_SIZE - 1);
+  q.count++;
+}
+
+void MotionHistory::expire(ExtremeQueue &q, uint32_t tail)
+{
+  while ( q.count > 0 && _samples[ q.slot[q.head] ].seq < tail ){
+    q.head = (q.head + 1) & (HISTORY_SIZE - 1);
+    q.count--;
+  }
+}
+
+bool MotionHistory::windowStats(int8_t handle, WindowStats &out)
+{
+  if ( handle < 0 || handle >= _numWindows || _count == 0 ) return false;
+  Window &w = _windows[handle];
+  out.count = _seq - w.tail + 1;
+  out.mean = w.sum / out.count;
+  out.min = _samples[ w.minQ.slot[w.minQ.head] ].value[w.channel];
+  out.max = _samples[ w.maxQ.slot[w.maxQ.head] ].value[w.channel];
+  //Full When The Sample Just Before The Tail Is Still Stored & Was Dropped For Being Too Old
+  uint32_t oldest = _seq - _count + 1;
+  out.full = w.tail > oldest && _samples[ _seq & (HISTORY_SIZE - 1) ].t - _samples[ (w.tail - 1) & (HISTORY_SIZE - 1) ].t > w.span;
+  return true;
+}
+
+HistorySample* MotionHistory::at(uint16_t age)
+{
+  if ( age >= _count ) return NULL;
+  return &_samples[ (_seq - age) & (HISTORY_SIZE - 1) ];
+}
+
+uint16_t MotionHistory::ageAtOrBefore(unsigned long spanMicros)
+{ //Smallest Age At Least spanMicros Older Than The Newest, Or _count If None
+  unsigned long newest = at(0) -> t;
+  uint16_t lo = 0, hi = _count;
+  while ( lo < hi ){
+    uint16_t mid = (lo + hi) / 2;
+    if ( newest - at(mid) -> t >= spanMicros ) hi = mid;
+    else lo = mid + 1;
+  }
+  return lo;
+}
+
+uint16_t MotionHistory::samplesSince(unsigned long spanMicros)
+{
+  if ( _count == 0 ) return 0;
+  uint16_t age = ageAtOrBefore( spanMicros );
+  //Include A Sample Sitting Right On The Edge
+  if ( age < _count && at(0) -> t - at(age) -> t == spanMicros ) age++;
+  return age;
+}
+
+bool MotionHistory::stats(uint8_t channel, unsigned long spanMicros, WindowStats &out)
+{
+  uint16_t n = samplesSince( spanMicros );
+  if ( n == 0 || channel >= CH_COUNT ) return false;
+  float v = at(0) -> value[channel];
+  out.min = v; out.max = v; out.mean = v;
+  for (uint16_t age = 1; age < n; age++){
+    v = at(age) -> value[channel];
+    if ( v < out.min ) out.min = v;
+    if ( v > out.max ) out.max = v;
+    out.mean += v;
+  }
+  out.mean /= n;
+  out.count = n;
+  out.full = n < _count;
+  return true;
+}
+
+bool MotionHistory::valueAt(uint8_t channel, unsigned long t, float &out)
+{
+  if ( _count == 0 || channel >= CH_COUNT ) return false;
+  HistorySample *newer = at(0);
+  long ahead = (long)(t - newer -> t);
+  if ( ahead > 0 ) return false; //Hasn't Happened Yet
+
+  uint16_t age = ageAtOrBefore( newer -> t - t );
+  if ( age >= _count ) return false; //Older Than What We Keep
+  HistorySample *older = at(age);
+  if ( age == 0 || older -> t == t ){ out = older -> value[channel]; return true; }
+
+  newer = at(age - 1);
+  float f = (float)(t - older -> t) / (float)(newer -> t - older -> t);
+  out = older -> value[channel] + f * ( newer -> value[channel] - older -> value[channel] );
+  return true;
+}
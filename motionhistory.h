@@ -0,0 +1,81 @@
+#include "application.h"
+
+#ifndef _INCL_MOTIONHISTORY
+#define _INCL_MOTIONHISTORY
+
+#include "detectors.h"
+
+class MotionEvent;
+
+#define HISTORY_SIZE 128      //Samples, Power Of Two & No More Than 256
+#define MAX_HISTORY_WINDOWS 4
+
+struct HistorySample {
+  uint32_t seq;
+  unsigned long t;
+  float value[CH_COUNT]; //Indexed By MotionChannel
+};
+
+struct WindowStats {
+  float min, max, mean;
+  uint16_t count;
+  bool full; //Reaches back the whole span, not just as far as the history goes
+};
+
+//Recent Motion Samples With Windowed Queries
+//Every sample keeps all MotionChannels, raw & derived. Windows registered with track() keep a running sum &
+//monotonic min/max queues, so their min/max/mean are O(1) per query & amortized O(1) per sample.
+//Anything else (stats() over an arbitrary span, valueAt()) walks the buffer.
+class MotionHistory
+{
+public:
+  MotionHistory() { reset(); };
+
+  void record(MotionEvent &motion);
+  void reset();
+
+  //Register A Window, Returns A Handle For windowStats() Or -1 When Full. It's filled from what's already stored
+  int8_t track(uint8_t channel, unsigned long spanMicros);
+  int8_t find(uint8_t channel, unsigned long spanMicros); //Handle of a window already tracked, -1 if none
+  bool windowStats(int8_t handle, WindowStats &out);
+
+  //Ad-Hoc Queries
+  bool stats(uint8_t channel, unsigned long spanMicros, WindowStats &out);
+  bool valueAt(uint8_t channel, unsigned long t, float &out); //Linear between the samples around t
+  uint16_t samplesSince(unsigned long spanMicros);
+
+  //age 0 is the newest sample, NULL past what's stored
+  HistorySample* at(uint16_t age);
+  uint16_t size() { return _count; };
+
+private:
+  //Ring Of Slots, Sliding Extremes Of One Window
+  struct ExtremeQueue {
+    uint8_t slot[HISTORY_SIZE];
+    uint16_t head, count;
+  };
+
+  struct Window {
+    uint8_t channel;
+    unsigned long span;
+    uint32_t tail; //Oldest sequence inside the window
+    float sum;
+    ExtremeQueue minQ, maxQ;
+  };
+
+  HistorySample _samples[HISTORY_SIZE];
+  uint32_t _seq;
+  uint16_t _count;
+  uint32_t _lastSampleSeq = 0; //MPU sample behind the newest entry, the same sample is never stored twice
+
+  Window _windows[MAX_HISTORY_WINDOWS];
+  uint8_t _numWindows = 0;
+
+  float value(uint32_t seq, uint8_t channel) { return _samples[ seq & (HISTORY_SIZE - 1) ].value[channel]; };
+  void push(ExtremeQueue &q, uint32_t seq, uint8_t channel, bool maximum);
+  void expire(ExtremeQueue &q, uint32_t tail);
+  void resetWindow(Window &w);
+  uint16_t ageAtOrBefore(unsigned long spanMicros);
+};
+
+#endif
@@ -195,6 +195,347 @@ void MPU_9250::MahonyQuaternionUpdate(float ax, float ay, float az, float gx, fl
         }
 
 
+//Multi-Rate Madgwick: Propagate Every Sample, Correct At The Rates Of The Current Motion Profile
+void MPU_9250::MultiRateQuaternionUpdate(float ax, float ay, float az, float gx, float gy, float gz, float mx, float my, float mz)
+{
+  FusionRates &rates = fusionRates[ fusionProfile() ];
+  uint32_t t0 = micros();
+  gyroPropagate(gx, gy, gz, deltat);
+  uint32_t t1 = micros();
+  recordFusionStep(propagateStats, t1 - t0);
+
+  accelCorrectionDt += deltat;
+  magCorrectionDt += deltat;
+
+  float accelHz = rates.accelHz * fusionRateScale;
+  float magHz = rates.magHz * fusionRateScale;
+  if ( accelHz > 0 && accelCorrectionDt * accelHz >= 1.0f )
+  {
+    t0 = micros();
+    accelCorrect(ax, ay, az, accelCorrectionDt);
+    t1 = micros();
+    recordFusionStep(accelStats, t1 - t0);
+    accelCorrectionDt = 0;
+  }
+
+  //No Point Correcting Against The Same Mag Sample Twice
+  if ( magUpdated && magHz > 0 && magCorrectionDt * magHz >= 1.0f )
+  {
+    t0 = micros();
+    magCorrect(mx, my, mz, magCorrectionDt);
+    t1 = micros();
+    recordFusionStep(magStats, t1 - t0);
+    magCorrectionDt = 0;
+    magUpdated = false;
+  }
+}
+
+//Integrate q' = 1/2 q x w
+void MPU_9250::gyroPropagate(float gx, float gy, float gz, float dt)
+{
+  float q1 = q.w, q2 = q.x, q3 = q.y, q4 = q.z;   // short name local variable for readability
+  float h = 0.5f * dt;
+  float norm;
+
+  q1 += (-q.x * gx - q.y * gy - q.z * gz) * h;
+  q2 += ( q.w * gx + q.y * gz - q.z * gy) * h;
+  q3 += ( q.w * gy - q.x * gz + q.z * gx) * h;
+  q4 += ( q.w * gz + q.x * gy - q.y * gx) * h;
+
+  norm = sqrt(q1 * q1 + q2 * q2 + q3 * q3 + q4 * q4);    // normalise quaternion
+  if (norm == 0.0f) return;
+  norm = 1.0f/norm;
+  q.w = q1 * norm;
+  q.x = q2 * norm;
+  q.y = q3 * norm;
+  q.z = q4 * norm;
+}
+
+//Gravity Only Gradient Step (The IMU Half Of Madgwick's Objective)
+void MPU_9250::accelCorrect(float ax, float ay, float az, float dt)
+{
+  float q1 = q.w, q2 = q.x, q3 = q.y, q4 = q.z;   // short name local variable for readability
+  float norm;
+  float s1, s2, s3, s4;
+
+  // Normalise accelerometer measurement
+  norm = sqrt(ax * ax + ay * ay + az * az);
+  if (norm == 0.0f) return; // handle NaN
+  norm = 1.0f/norm;
+  ax *= norm;
+  ay *= norm;
+  az *= norm;
+
+  // Auxiliary variables to avoid repeated arithmetic
+  float _2q1 = 2.0f * q1;
+  float _2q2 = 2.0f * q2;
+  float _2q3 = 2.0f * q3;
+  float _2q4 = 2.0f * q4;
+  float _4q1 = 4.0f * q1;
+  float _4q2 = 4.0f * q2;
+  float _4q3 = 4.0f * q3;
+  float _8q2 = 8.0f * q2;
+  float _8q3 = 8.0f * q3;
+  float q1q1 = q1 * q1;
+  float q2q2 = q2 * q2;
+  float q3q3 = q3 * q3;
+  float q4q4 = q4 * q4;
+
+  // Gradient decent algorithm corrective step
+  s1 = _4q1 * q3q3 + _2q3 * ax + _4q1 * q2q2 - _2q2 * ay;
+  s2 = _4q2 * q4q4 - _2q4 * ax + 4.0f * q1q1 * q2 - _2q1 * ay - _4q2 + _8q2 * q2q2 + _8q2 * q3q3 + _4q2 * az;
+  s3 = 4.0f * q1q1 * q3 + _2q1 * ax + _4q3 * q4q4 - _2q4 * ay - _4q3 + _8q3 * q2q2 + _8q3 * q3q3 + _4q3 * az;
+  s4 = 4.0f * q2q2 * q4 - _2q2 * ax + 4.0f * q3q3 * q4 - _2q3 * ay;
+  norm = sqrt(s1 * s1 + s2 * s2 + s3 * s3 + s4 * s4);    // normalise step magnitude
+  if (norm == 0.0f) return; // already aligned
+  norm = beta * dt / norm;
+
+  q1 -= s1 * norm;
+  q2 -= s2 * norm;
+  q3 -= s3 * norm;
+  q4 -= s4 * norm;
+  norm = sqrt(q1 * q1 + q2 * q2 + q3 * q3 + q4 * q4);    // normalise quaternion
+  norm = 1.0f/norm;
+  q.w = q1 * norm;
+  q.x = q2 * norm;
+  q.y = q3 * norm;
+  q.z = q4 * norm;
+}
+
+//Magnetic Field Only Gradient Step (The Mag Half Of Madgwick's Objective)
+void MPU_9250::magCorrect(float mx, float my, float mz, float dt)
+{
+  float q1 = q.w, q2 = q.x, q3 = q.y, q4 = q.z;   // short name local variable for readability
+  float norm;
+  float hx, hy, _2bx, _2bz, _4bx, _4bz;
+  float fx, fy, fz;
+  float s1, s2, s3, s4;
+
+  // Normalise magnetometer measurement
+  norm = sqrt(mx * mx + my * my + mz * mz);
+  if (norm == 0.0f) return; // handle NaN
+  norm = 1.0f/norm;
+  mx *= norm;
+  my *= norm;
+  mz *= norm;
+
+  // Auxiliary variables to avoid repeated arithmetic
+  float _2q1mx = 2.0f * q1 * mx;
+  float _2q1my = 2.0f * q1 * my;
+  float _2q1mz = 2.0f * q1 * mz;
+  float _2q2mx = 2.0f * q2 * mx;
+  float _2q2 = 2.0f * q2;
+  float _2q3 = 2.0f * q3;
+  float q1q1 = q1 * q1;
+  float q1q2 = q1 * q2;
+  float q1q3 = q1 * q3;
+  float q1q4 = q1 * q4;
+  float q2q2 = q2 * q2;
+  float q2q3 = q2 * q3;
+  float q2q4 = q2 * q4;
+  float q3q3 = q3 * q3;
+  float q3q4 = q3 * q4;
+  float q4q4 = q4 * q4;
+
+  // Reference direction of Earth's magnetic field
+  hx = mx * q1q1 - _2q1my * q4 + _2q1mz * q3 + mx * q2q2 + _2q2 * my * q3 + _2q2 * mz * q4 - mx * q3q3 - mx * q4q4;
+  hy = _2q1mx * q4 + my * q1q1 - _2q1mz * q2 + _2q2mx * q3 - my * q2q2 + my * q3q3 + _2q3 * mz * q4 - my * q4q4;
+  _2bx = sqrt(hx * hx + hy * hy);
+  _2bz = -_2q1mx * q3 + _2q1my * q2 + mz * q1q1 + _2q2mx * q4 - mz * q2q2 + _2q3 * my * q4 - mz * q3q3 + mz * q4q4;
+  _4bx = 2.0f * _2bx;
+  _4bz = 2.0f * _2bz;
+
+  // Objective function: predicted minus measured field
+  fx = _2bx * (0.5f - q3q3 - q4q4) + _2bz * (q2q4 - q1q3) - mx;
+  fy = _2bx * (q2q3 - q1q4) + _2bz * (q1q2 + q3q4) - my;
+  fz = _2bx * (q1q3 + q2q4) + _2bz * (0.5f - q2q2 - q3q3) - mz;
+
+  // Gradient decent algorithm corrective step
+  s1 = -_2bz * q3 * fx + (-_2bx * q4 + _2bz * q2) * fy + _2bx * q3 * fz;
+  s2 = _2bz * q4 * fx + (_2bx * q3 + _2bz * q1) * fy + (_2bx * q4 - _4bz * q2) * fz;
+  s3 = (-_4bx * q3 - _2bz * q1) * fx + (_2bx * q2 + _2bz * q4) * fy + (_2bx * q1 - _4bz * q3) * fz;
+  s4 = (-_4bx * q4 + _2bz * q2) * fx + (-_2bx * q1 + _2bz * q3) * fy + _2bx * q2 * fz;
+  norm = sqrt(s1 * s1 + s2 * s2 + s3 * s3 + s4 * s4);    // normalise step magnitude
+  if (norm == 0.0f) return; // already aligned
+  norm = betaMag * dt / norm;
+
+  q1 -= s1 * norm;
+  q2 -= s2 * norm;
+  q3 -= s3 * norm;
+  q4 -= s4 * norm;
+  norm = sqrt(q1 * q1 + q2 * q2 + q3 * q3 + q4 * q4);    // normalise quaternion
+  norm = 1.0f/norm;
+  q.w = q1 * norm;
+  q.x = q2 * norm;
+  q.y = q3 * norm;
+  q.z = q4 * norm;
+}
+
+//Fusion Rates Follow The Motion State
+int MPU_9250::fusionProfile()
+{
+  int profile = frisbeem._motionState.currentState;
+  if ( profile < 0 || profile >= FUSION_PROFILES ){ profile = FUSION_PROFILES - 1; }
+  return profile;
+}
+
+void MPU_9250::recordFusionStep(FusionStepStats &stats, uint32_t elapsed)
+{
+  stats.calls++;
+  stats.totalMicros += elapsed;
+  if ( elapsed > stats.maxMicros ){ stats.maxMicros = elapsed; }
+}
+
+void MPU_9250::resetFusionStats()
+{
+  propagateStats = FusionStepStats();
+  accelStats = FusionStepStats();
+  magStats = FusionStepStats();
+}
+
+//Seed The Attitude From A Short Average Of Accel & Mag (Blocking, Boot & Wake Only)
+bool MPU_9250::seedAttitude()
+{
+  VectorFloat aSum, mSum;
+  uint16_t aN = 0, mN = 0;
+  uint32_t start = millis();
+
+  getAres();
+  getMres();
+  while ( aN < seedSamples && millis() - start < seedTimeout )
+  {
+    if (readByte(MPU9250_ADDRESS, INT_STATUS) & 0x01) {
+      readAccelData(accelCount);
+      aSum.x += (float)accelCount[0]*aRes;
+      aSum.y += (float)accelCount[1]*aRes;
+      aSum.z += (float)accelCount[2]*aRes;
+      aN++;
+    }
+    if (readByte(AK8963_ADDRESS, AK8963_ST1) & 0x01) { // Mag only runs at 100Hz, take what shows up
+      readMagData(magCount);
+      mSum.x += (float)magCount[0]*mRes*magCalibration[0] - magbias[0];
+      mSum.y += (float)magCount[1]*mRes*magCalibration[1] - magbias[1];
+      mSum.z += (float)magCount[2]*mRes*magCalibration[2] - magbias[2];
+      mN++;
+    }
+  }
+  if (aN == 0){
+    frisbeem._com.log("Attitude Seed Failed: No Accel Data");
+    return false;
+  }
+
+  A.x = aSum.x / aN; A.y = aSum.y / aN; A.z = aSum.z / aN;
+  if (mN > 0){
+    M.x = mSum.x / mN; M.y = mSum.y / mN; M.z = mSum.z / mN;
+  }
+  return seedAttitude( A, VectorFloat(M.y, M.x, M.z) );
+}
+
+//TRIAD: Build The Earth Frame (North, West, Up) In Sensor Coordinates & Convert To A Quaternion
+bool MPU_9250::seedAttitude(VectorFloat acc, VectorFloat mag)
+{
+  //Up Is The Measured Specific Force
+  float norm = acc.getMagnitude();
+  if (norm == 0.0f) return false;
+  float ux = acc.x / norm, uy = acc.y / norm, uz = acc.z / norm;
+
+  //North Is The Horizontal Part Of The Magnetic Field
+  float dip = mag.x * ux + mag.y * uy + mag.z * uz;
+  float nx = mag.x - dip * ux, ny = mag.y - dip * uy, nz = mag.z - dip * uz;
+  norm = sqrt(nx * nx + ny * ny + nz * nz);
+  if (norm < 0.01f * mag.getMagnitude() || norm == 0.0f)
+  { //No Usable Mag (Not Read Yet Or Aligned With Gravity), Take Sensor X Projected Flat As North
+    nx = 1.0f - ux * ux; ny = -ux * uy; nz = -ux * uz;
+    norm = sqrt(nx * nx + ny * ny + nz * nz);
+    if (norm < 0.01f){ //Sensor X Is Vertical, Use Sensor Y Instead
+      nx = -uy * ux; ny = 1.0f - uy * uy; nz = -uy * uz;
+      norm = sqrt(nx * nx + ny * ny + nz * nz);
+    }
+  }
+  norm = 1.0f / norm;
+  nx *= norm; ny *= norm; nz *= norm;
+
+  //West Completes The Right Handed Frame
+  float wx = uy * nz - uz * ny;
+  float wy = uz * nx - ux * nz;
+  float wz = ux * ny - uy * nx;
+
+  //Rows Of The Sensor->Earth Rotation Are (n, w, u). Convert To Quaternion (Shepperd)
+  float trace = nx + wy + uz;
+  float s;
+  if (trace > 0.0f){
+    s = 2.0f * sqrt(trace + 1.0f);
+    q.w = 0.25f * s;
+    q.x = (uy - wz) / s;
+    q.y = (nz - ux) / s;
+    q.z = (wx - ny) / s;
+  }
+  else if (nx > wy && nx > uz){
+    s = 2.0f * sqrt(1.0f + nx - wy - uz);
+    q.w = (uy - wz) / s;
+    q.x = 0.25f * s;
+    q.y = (ny + wx) / s;
+    q.z = (nz + ux) / s;
+  }
+  else if (wy > uz){
+    s = 2.0f * sqrt(1.0f + wy - nx - uz);
+    q.w = (nz - ux) / s;
+    q.x = (ny + wx) / s;
+    q.y = 0.25f * s;
+    q.z = (wz + uy) / s;
+  }
+  else{
+    s = 2.0f * sqrt(1.0f + uz - nx - wy);
+    q.w = (wx - ny) / s;
+    q.x = (nz + ux) / s;
+    q.y = (wz + uy) / s;
+    q.z = 0.25f * s;
+  }
+  q.normalize();
+
+  //Everything Downstream Of q Was Built On The Old Attitude
+  V = VectorFloat(); Alast = VectorFloat();
+  zupt.reset( zupt.X );
+  Axy_lp = 0;
+  lp_err_running_count = 0;
+  divergenceCount = 0;
+  accelCorrectionDt = 0;
+  magCorrectionDt = 0;
+  dmpGetGravity( Grav );
+  lastUpdate = micros(); //Don't Integrate Across The Seed
+  attitudeSeeded = true;
+  return true;
+}
+
+//Seed From The Last Sample, Only If It's Clean Gravity
+bool MPU_9250::reseedIfStill()
+{
+  if ( fabs(A.getMagnitude() - 1.0f) > stillAccelTol || G.getMagnitude() > stillGyroThresh ) return false;
+  return seedAttitude( A, VectorFloat(M.y, M.x, M.z) );
+}
+
+//Re-seed If The Fused Gravity Disagrees With The Accelerometer While The Disc Is Still
+void MPU_9250::checkAttitudeDivergence()
+{
+  if ( q.w != q.w ){ //NaN Never Recovers On Its Own
+    seedAttitude( A, VectorFloat(M.y, M.x, M.z) );
+    return;
+  }
+  float aMag = A.getMagnitude();
+  if ( fabs(aMag - 1.0f) > stillAccelTol || G.getMagnitude() > stillGyroThresh ){
+    divergenceCount = 0; //Accel Isn't Gravity Right Now, Can't Judge
+    return;
+  }
+  //Grav Is Unit Length So This Is The Cosine Between Them
+  float c = (Grav.x * A.x + Grav.y * A.y + Grav.z * A.z) / aMag;
+  if ( c < divergenceCos ){ divergenceCount++; }
+  else { divergenceCount = 0; }
+  if ( divergenceCount > divergenceCountThresh ){
+    frisbeem._com.log("Attitude Diverged, Re-seeding");
+    seedAttitude( A, VectorFloat(M.y, M.x, M.z) );
+  }
+}
+
 void MPU_9250::initialize()
 {
   Wire.begin();
@@ -231,6 +572,9 @@ void MPU_9250::initialize()
 
     initMPU9250();
     frisbeem._com.log("MPU9250 initialized for active data mode...."); // Initialize device for active mode read of acclerometer, gyroscope, and temperature
+    getAres();
+    getGres();
+    impact.setScale(aRes, gRes);
 
     // Read the WHO_AM_I register of the magnetometer, this is a good test of communication
     byte d = readByte(AK8963_ADDRESS, WHO_AM_I_AK8963);  // Read WHO_AM_I register for AK8963
@@ -241,6 +585,9 @@ void MPU_9250::initialize()
     frisbeem._com.log("AK8963 initialized for active data mode...."); // Initialize device for active mode read of magnetometer
 
     delay(1000);
+
+    //Start From A Real Attitude Instead Of Waiting For Madgwick To Converge
+    if ( seedAttitude() ){ frisbeem._com.log("Attitude Seeded"); }
   }
   else
   {
@@ -251,27 +598,23 @@ void MPU_9250::initialize()
 
 void MPU_9250::update()
 {
-  // If intPin goes high, all data registers have new data
-  if (readByte(MPU9250_ADDRESS, INT_STATUS) & 0x01) {
-    frisbeem._com.log("Interrupt"); // On interrupt, check if data ready interrupt
-    frisbeem._com.log("Reading ACL");
-    readAccelData(accelCount);  // Read the x/y/z adc values
-    frisbeem._com.log("Got ACL");
+  //Everything The FIFO Collected Since Last Time, Impacts Were Already Checked Sample By Sample
+  int32_t gyroSum[3] = {0, 0, 0};
+  lastBatch = readFifo( gyroSum );
+  bool fresh = lastBatch > 0;
+  if (fresh) {
     getAres();
-    // Now we'll calculate the accleration value into actual g's
+    // Now we'll calculate the accleration value into actual g's, newest sample
     A.x = (float)accelCount[0]*aRes; // - accelBias[0];  // get actual g value, this depends on scale being set
     A.y = (float)accelCount[1]*aRes; // - accelBias[1];
     A.z = (float)accelCount[2]*aRes; // - accelBias[2];
 
-    frisbeem._com.log("Reading Gyro");
-    readGyroData(gyroCount);  // Read the x/y/z adc values
     getGres();
-    frisbeem._com.log("Got Gyro");
-
     // Calculate the gyro value into actual degrees per second
-    G.x = (float)gyroCount[0]*gRes;  // get actual gyro value, this depends on scale being set
-    G.y = (float)gyroCount[1]*gRes;
-    G.z = (float)gyroCount[2]*gRes;
+    // Averaged over the batch, so one fusion step over its span integrates the same rotation
+    G.x = (float)gyroSum[0]*gRes / lastBatch;
+    G.y = (float)gyroSum[1]*gRes / lastBatch;
+    G.z = (float)gyroSum[2]*gRes / lastBatch;
 
     frisbeem._com.log("Reading MAG");
     readMagData(magCount);  // Read the x/y/z adc values
@@ -288,13 +631,53 @@ void MPU_9250::update()
     M.z = (float)magCount[2]*mRes*magCalibration[2] - magbias[2];
   }
   else{
-    frisbeem._com.log("No Interrupt");
+    return; //Nothing New, Integrating Again Would Count The Last Batch Twice
   }
 
   sum += deltat; // sum for averaging filter update rate
   sumCount++;
 
   calculatePositionalInformation();
+  frisbeem._latency.record( LAT_FUSION, sampleTime );
+}
+
+//Read Frames Oldest First, Feeding Each To The Impact Detector
+uint16_t MPU_9250::readFifo(int32_t *gyroSum)
+{
+  uint8_t raw[MPU_FIFO_FRAME];
+  readBytes(MPU9250_ADDRESS, FIFO_COUNTH, 2, raw);
+  uint16_t bytes = ((uint16_t)(raw[0] & 0x1F) << 8) | raw[1];
+  if ( bytes >= MPU_FIFO_SIZE ){ //Overflowed, Can't Tell Where The Frames Start Any More
+    fifoOverflows++;
+    resetFifo();
+    return 0;
+  }
+  uint16_t frames = bytes / MPU_FIFO_FRAME;
+  if ( frames > MPU_FIFO_BATCH ) frames = MPU_FIFO_BATCH;
+  if ( frames == 0 ) return 0;
+
+  sampleTime = micros();
+  uint32_t period = 1000UL * (1 + sampleDiv); //Output Data Rate Spacing
+  for (uint16_t i = 0; i < frames; i++){
+    readBytes(MPU9250_ADDRESS, FIFO_R_W, MPU_FIFO_FRAME, raw);
+    for (uint8_t k = 0; k < 3; k++){
+      accelCount[k] = ((int16_t)raw[2*k] << 8) | raw[2*k + 1];
+      gyroCount[k] = ((int16_t)raw[6 + 2*k] << 8) | raw[6 + 2*k + 1];
+      gyroSum[k] += gyroCount[k];
+    }
+    sampleSeq++;
+    //Impacts Are Only A Few Samples Wide, Every Raw Sample Goes Through, Stamped Back From The Newest
+    impact.update(accelCount, gyroCount[2], sampleTime - (frames - 1 - i) * period);
+  }
+  return frames;
+}
+
+void MPU_9250::resetFifo()
+{
+  writeByte(MPU9250_ADDRESS, FIFO_EN, 0x00);
+  writeByte(MPU9250_ADDRESS, USER_CTRL, 0x04);  // Reset FIFO, bypass stays on for the mag
+  writeByte(MPU9250_ADDRESS, USER_CTRL, 0x40);  // Enable FIFO
+  writeByte(MPU9250_ADDRESS, FIFO_EN, 0x78);    // Gyro and accelerometer, 12 bytes per sample
 }
 
 //Positional Information Calculations
@@ -310,12 +693,14 @@ void MPU_9250::calculatePositionalInformation(){
   deltat = ((now - lastUpdate)/1000000.0f); // set integration time by time elapsed since last filter update
 
   frisbeem._com.log("Madgwick");
-  MadgwickQuaternionUpdate(A.x,A.y,A.z,G.x*PI/180.0f,G.y*PI/180.0f,G.z*PI/180.0f,M.y,M.x,M.z);
+  MultiRateQuaternionUpdate(A.x,A.y,A.z,G.x*PI/180.0f,G.y*PI/180.0f,G.z*PI/180.0f,M.y,M.x,M.z);
+  // MadgwickQuaternionUpdate(A.x,A.y,A.z,G.x*PI/180.0f,G.y*PI/180.0f,G.z*PI/180.0f,M.y,M.x,M.z);
 
   // frisbeem._com.log("Mahony");
   // MahonyQuaternionUpdate(A.x,A.y,A.z,G.x*PI/180.0f,G.y*PI/180.0f,G.z*PI/180.0f,M.y,M.x,M.z);
   frisbeem._com.log("Grav");
   dmpGetGravity( Grav );
+  checkAttitudeDivergence();
   frisbeem._com.log("LinAccel");
   dmpGetLinearAccel(Alin, A, Grav);
   frisbeem._com.log("A World");
@@ -343,48 +728,19 @@ void MPU_9250::calculateInplaneAcceleration()
   if (Axy < Axy_MagThresh){ rest = true; }
   else{ rest = false; }
 }
-//Performs Double Integration
+//Performs Double Integration, Drift Is Removed At Each Zero Velocity Update
 void MPU_9250::determineVelocityNPosition(VectorFloat &Awrld, VectorFloat &Vel, VectorFloat &Pos)
 {
-  //Store Last Iteration Variables
-  float vx,vy,vz;
-  vx = Vel.x; vy = Vel.y; vz = Vel.z;
-
-  float h = deltat / 2.0;
-
-  if ( rest == false )
-  { //Perform Integration If Moving (Not Resting )
-    float h_mps = h * 9.81; //Gravity Beeches
-    Vel.x += ( Awrld.x + Alast.x ) * h_mps;
-    Vel.y += ( Awrld.y + Alast.y ) * h_mps;
-    Vel.z += ( Awrld.z + Alast.z ) * h_mps;
+  //A Gliding Disc Reads ~1g Of Lift & Looks At Rest, So Trust The Phase Over The Raw Flag
+  zupt.update( Awrld, deltat, frisbeem._motionState.stationary() );
+  Vel = zupt.V;
+  Pos = zupt.X;
+  if (Pos.z < 0){ //Protect Against Going Through Floor
+    Pos.z = 0;
   }
-  else
-  { //If Resting Set Velocity Zero
-    Vel.x = 0;
-    Vel.y = 0;
-    Vel.z = 0;
-  }
-  //If Spinning Integrate Position
-  if ( frisbeem._motionState.currentState == 2){
-    Pos.x += ( Vel.x + vx ) * h;
-    Pos.y += ( Vel.y + vy ) * h;
-    Pos.z += ( Vel.z + vz ) * h;
-    if (Pos.z < 0){ //Protect Against Going Through Floor
-      Pos.z = 0;
-    }
-  }
-  //If Resting Set Position To 0,0,1 m off ground
-  else if ( rest ){
-      Pos.x = 0;
-      Pos.y = 0;
-      Pos.z = 1;
-  }
-
 
   //Store This Acceleration Value
   Alast.x = Awrld.x; Alast.y = Awrld.y; Alast.z = Awrld.z;
-
 }
 
 //===================================================================================================================
@@ -496,6 +852,7 @@ void MPU_9250::readMagData(int16_t * destination)
       destination[0] = ((int16_t)rawData[1] << 8) | rawData[0] ;  // Turn the MSB and LSB into a signed 16-bit value
       destination[1] = ((int16_t)rawData[3] << 8) | rawData[2] ;  // Data stored as little Endian
       destination[2] = ((int16_t)rawData[5] << 8) | rawData[4] ;
+      magUpdated = true;
    }
   }
 }
@@ -585,8 +942,47 @@ void MPU_9250::initMPU9250()
    writeByte(MPU9250_ADDRESS, INT_PIN_CFG, 0x22);
    writeByte(MPU9250_ADDRESS, INT_ENABLE, 0x01);  // Enable data ready (bit 0) interrupt
    delay(100);
+
+  // Samples are read out of the FIFO so none are lost between loop iterations
+   resetFifo();
+}
+
+
+//Power Modes Trade Bandwidth For Current, Full Scale & Interrupt Setup Are Left Alone
+void MPU_9250::setSampleRate(uint8_t sampleDiv, uint8_t dlpf)
+{
+  uint8_t c = readByte(MPU9250_ADDRESS, CONFIG);
+  writeByte(MPU9250_ADDRESS, CONFIG, (c & ~0x07) | (dlpf & 0x07));
+  c = readByte(MPU9250_ADDRESS, ACCEL_CONFIG2);
+  writeByte(MPU9250_ADDRESS, ACCEL_CONFIG2, (c & ~0x0F) | (dlpf & 0x07)); // accel_fchoice_b stays 0
+  writeByte(MPU9250_ADDRESS, SMPLRT_DIV, sampleDiv);
+  this -> sampleDiv = sampleDiv;
+  resetFifo(); //Queued Samples Were Spaced At The Old Rate
 }
 
+//Accel Only, Duty Cycled At lpOdr. intPin Goes High When Any Axis Moves More Than thresholdMg Between Samples
+void MPU_9250::enableWakeOnMotion(uint16_t thresholdMg, uint8_t lpOdr)
+{
+  writeByte(MPU9250_ADDRESS, PWR_MGMT_1, 0x00);      // Awake, not cycling, internal oscillator
+  writeByte(MPU9250_ADDRESS, PWR_MGMT_2, 0x07);      // Accel on, gyro off
+  writeByte(MPU9250_ADDRESS, ACCEL_CONFIG2, 0x01);   // accel_fchoice_b = 0, 184 Hz bandwidth
+  writeByte(MPU9250_ADDRESS, INT_ENABLE, 0x40);      // Wake on motion interrupt only
+  writeByte(MPU9250_ADDRESS, MOT_DETECT_CTRL, 0xC0); // ACCEL_INTEL_EN, compare each sample with the previous one
+  writeByte(MPU9250_ADDRESS, WOM_THR, constrain(thresholdMg / 4, 1, 255)); // 4 mg per LSB
+  writeByte(MPU9250_ADDRESS, LP_ACCEL_ODR, lpOdr & 0x0F);
+  writeByte(MPU9250_ADDRESS, PWR_MGMT_1, 0x20);      // Cycle: sleep, wake for one accel sample, repeat
+  readByte(MPU9250_ADDRESS, INT_STATUS);             // Interrupt is latched until read, so the next edge is a new one
+}
+
+//Back To Full Sampling. True When Motion (Not A Timeout) Is What Ended The Sleep
+bool MPU_9250::disableWakeOnMotion()
+{
+  bool moved = readByte(MPU9250_ADDRESS, INT_STATUS) & 0x40;
+  writeByte(MPU9250_ADDRESS, MOT_DETECT_CTRL, 0x00);
+  writeByte(MPU9250_ADDRESS, PWR_MGMT_2, 0x00);      // Gyro back on
+  initMPU9250();
+  return moved;
+}
 
 // Function which accumulates gyro and accelerometer data after device initialization. It calculates the average
 // of the at-rest readings and then loads the resulting offsets into accelerometer and gyro bias registers.
@@ -846,7 +1242,6 @@ uint8_t MPU_9250::readByte(uint8_t address, uint8_t subAddress)
 
 void MPU_9250::readBytes(uint8_t address, uint8_t subAddress, uint8_t count, uint8_t * dest)
 {
-  frisbeem._com.log("Reading "+String(count,DEC)+" Bytes From "+String(address,HEX)+"||"+String(subAddress,HEX));
   Wire.beginTransmission(address);   // Initialize the Tx buffer
   Wire.write(subAddress);            // Put slave register address in Tx buffer
   Wire.endTransmission(false);       // Send the Tx buffer, but send a restart to keep connection alive
@@ -29,6 +29,13 @@
 #include "math.h"
 #include "3dmath.h"
 #include "mpu9250_registers.h"
+#include "zupt.h"
+#include "impact.h"
+
+#define FUSION_PROFILES 8 //One Per MotionSwitch State
+#define MPU_FIFO_SIZE 512  //Bytes, the count saturates here when it overflows
+#define MPU_FIFO_FRAME 12  //Accel then gyro, 3 big endian words each
+#define MPU_FIFO_BATCH 32  //Most frames drained per update, the rest wait for the next one
 
 class MPU_9250 {
 
@@ -55,7 +62,7 @@ class MPU_9250 {
 
   // Specify sensor full scale
   uint8_t Gscale = GFS_2000DPS;
-  uint8_t Ascale = AFS_4G;
+  uint8_t Ascale = AFS_16G;    // Catches & ground strikes clip at 4g, we need the headroom for the impact detector
   uint8_t Mscale = MFS_16BITS; // Choose either 14-bit or 16-bit magnetometer resolution
   uint8_t Mmode = 0x06;        // 2 for 8 Hz, 6 for 100 Hz continuous magnetometer data read
   float aRes, gRes, mRes;      // scale resolutions per LSB for the sensors
@@ -108,11 +115,64 @@ class MPU_9250 {
 
   bool rest = true;
 
+  //Attitude Seeding
+  //Madgwick takes seconds to walk q in from identity, so we solve for it directly (TRIAD) from
+  //averaged accel/mag at boot & wake, and again whenever the fused gravity stops agreeing with the accelerometer
+  uint16_t seedSamples = 20;            // accel samples averaged for a seed (~20ms at 1kHz)
+  uint32_t seedTimeout = 40;            // ms to wait for seedSamples before giving up with what we have
+  float divergenceCos = 0.9;            // cos of the max angle between fused & measured gravity while still (~25deg)
+  float stillGyroThresh = 10;           // deg/s under which the disc is considered still for divergence checks
+  float stillAccelTol = 0.1;            // g tolerance on |A| = 1g for divergence checks
+  int divergenceCount = 0;
+  int divergenceCountThresh = 50;       // consecutive diverged samples before we re-seed
+  bool attitudeSeeded = false;
+
+  //Multi-Rate Fusion
+  //Gyro propagation runs on every sample, the accel & mag gradient corrections run at their own rates.
+  //Rates are picked per motion state so we can trade CPU against attitude quality. 0Hz disables a correction
+  struct FusionRates {
+    float accelHz;
+    float magHz;
+  };
+  FusionRates fusionRates[FUSION_PROFILES] = {
+    {50, 10},   // REST
+    {200, 50},  // MOTION
+    {500, 100}, // SPIN
+    {200, 50},  // WINDUP
+    {500, 100}, // RELEASE
+    {500, 100}, // FLIGHT
+    {200, 50},  // CATCH
+    {50, 10},   // LANDED
+  };
+  float fusionRateScale = 1;  // Power mode multiplier on the correction rates
+  float betaMag = sqrt(3.0f / 4.0f) * GyroMeasError; // mag correction gain, same register as beta
+  float accelCorrectionDt = 0, magCorrectionDt = 0;  // time accumulated since each correction last ran
+  bool magUpdated = false;                           // set when readMagData applies a fresh sample
+
+  //Per Step Cost
+  struct FusionStepStats {
+    uint32_t calls;
+    uint32_t totalMicros;
+    uint32_t maxMicros;
+  };
+  FusionStepStats propagateStats = {0, 0, 0}, accelStats = {0, 0, 0}, magStats = {0, 0, 0};
+
   //Raw Measurements
   VectorFloat A, G, M;
   //Intermediate Vectors For High Level Positional Algorithm
   VectorFloat Grav, Alin, Awrld, Alast, V, X;
   Quaternion q;
+  ZuptIntegrator zupt; //Owns V & X, copied out each update
+  ImpactDetector impact; //Runs on every raw sample
+
+  //Stamped On Every Raw Sample, Carried Through Events, Telemetry & Light Frames
+  uint32_t sampleSeq = 0;
+  unsigned long sampleTime = 0; //micros() at capture
+
+  //Raw Samples Queue In The FIFO Between Updates, So A Slow Loop Iteration Doesn't Lose Any
+  uint8_t sampleDiv = 0;        //Current SMPLRT_DIV, sets the spacing of FIFO samples
+  uint16_t lastBatch = 0;       //Samples drained by the last update
+  uint32_t fifoOverflows = 0;
   float eInt[3] = {0.0f, 0.0f, 0.0f};       // vector to hold integral error for Mahony method
 
   uint8_t orientationPacket[14] = { '$', 0x02, 0,0, 0,0, 0,0, 0,0, 0x00, 0x00, '\r', '\n' };
@@ -129,6 +189,22 @@ class MPU_9250 {
    // Similar to Madgwick scheme but uses proportional and integral filtering on the error between estimated reference vectors and
    // measured ones.
   void MahonyQuaternionUpdate(float ax, float ay, float az, float gx, float gy, float gz, float mx, float my, float mz);
+
+  // Madgwick split by sensor: cheap gyro propagation every sample, gradient corrections at fusionRates
+  void MultiRateQuaternionUpdate(float ax, float ay, float az, float gx, float gy, float gz, float mx, float my, float mz);
+  void gyroPropagate(float gx, float gy, float gz, float dt);
+  void accelCorrect(float ax, float ay, float az, float dt);
+  void magCorrect(float mx, float my, float mz, float dt);
+  int fusionProfile();
+  void recordFusionStep(FusionStepStats &stats, uint32_t elapsed);
+  void resetFusionStats();
+
+  // Closed form attitude from gravity & magnetic north (TRIAD). seedAttitude() averages a short burst of
+  // samples (blocking, boot/wake only), seedAttitude(acc, mag) uses a single snapshot and is safe in the loop.
+  // mag is expected in the same axis order passed to the fusion filters (M.y, M.x, M.z)
+  bool seedAttitude();
+  bool seedAttitude(VectorFloat acc, VectorFloat mag);
+  void checkAttitudeDivergence();
   void initialize();
   void update();
 
@@ -148,6 +224,12 @@ class MPU_9250 {
   int16_t readTempData();
   void initAK8963(float * destination);
   void initMPU9250();
+  void setSampleRate(uint8_t sampleDiv, uint8_t dlpf); // ODR = 1kHz / (1 + sampleDiv), DLPF_CFG for gyro & accel
+  void resetFifo();
+  uint16_t readFifo(int32_t *gyroSum); // Drains up to MPU_FIFO_BATCH frames, returns how many
+  bool reseedIfStill();
+  void enableWakeOnMotion(uint16_t thresholdMg, uint8_t lpOdr); // lpOdr is LP_ACCEL_ODR, 0.24 Hz << lpOdr
+  bool disableWakeOnMotion();
 
   //Motion Intellegence
   void calculatePositionalInformation();
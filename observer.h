@@ -3,6 +3,8 @@
 class Event;
 class MotionEvent;
 class COMEvent;
+class ImpactEvent;
+class GestureEvent;
 
 class IObserver //In which we notify
 {
@@ -18,7 +20,8 @@ public:
   virtual void onNotify( Event &event ){};
   virtual void onNotify( MotionEvent &motion){};
   virtual void onNotify( COMEvent &com){};
-  uint8_t _index;
+  virtual void onNotify( ImpactEvent &impact){};
+  virtual void onNotify( GestureEvent &gesture){};
 
   virtual String name() {return "Observer";};
 };
@@ -0,0 +1,117 @@
+#include "pov.h"
+
+#define UNITS_PER_DEGREE 11930464.71f //2^32 / 360
+
+static uint32_t toUnits(float degrees)
+{
+  degrees = fmod( degrees, 360.0f );
+  if ( degrees < 0 ) degrees += 360;
+  return (uint32_t)( degrees * UNITS_PER_DEGREE );
+}
+
+void PovRenderer::setLayout(uint8_t leds, const float *angles, const uint8_t *rows)
+{
+  _leds = leds > POV_MAX_LEDS ? POV_MAX_LEDS : leds;
+  for (uint8_t i = 0; i < _leds; i++){
+    _ledColumn[i] = toUnits( angles[i] ) >> (32 - POV_COLUMN_BITS);
+    _ledRow[i] = rows == NULL ? 0 : rows[i] % POV_ROWS;
+  }
+  _shownColumn = 0xFFFF;
+}
+
+void PovRenderer::ringLayout(uint8_t leds)
+{
+  _leds = leds > POV_MAX_LEDS ? POV_MAX_LEDS : leds;
+  for (uint8_t i = 0; i < _leds; i++){
+    _ledColumn[i] = (uint32_t) i * POV_COLUMNS / _leds;
+    _ledRow[i] = 0;
+  }
+  _shownColumn = 0xFFFF;
+}
+
+void PovRenderer::setPhase(float angle, float rate, unsigned long now)
+{ //Fill The Slot The Interrupt Isn't Reading, Then Flip. A Single Byte Store, So It Sees One Or The Other
+  PhaseSlot &next = _slots[ _live ^ 1 ];
+  next.phase = toUnits( angle );
+  next.rate = (int32_t)( rate * UNITS_PER_DEGREE / 1E6 );
+  next.minRate = (int32_t)( minRate * UNITS_PER_DEGREE / 1E6 );
+  next.at = now;
+  _live ^= 1;
+}
+
+uint32_t PovRenderer::phase(unsigned long now)
+{
+  PhaseSlot &slot = _slots[_live];
+  int32_t elapsed = now - slot.at;
+  return slot.phase + (uint32_t)( (int64_t) slot.rate * elapsed );
+}
+
+bool PovRenderer::latch(unsigned long now)
+{
+  polls++;
+  if ( !running() ) return false;
+  uint16_t c = column( now );
+  if ( c == latchedColumn ) return false;
+  latchedColumn = c;
+  latches++;
+  return true;
+}
+
+bool PovRenderer::show(unsigned long now)
+{
+  if ( !enabled ) return false;
+  if ( !spinning() ){
+    if ( _lit ) blank();
+    return false;
+  }
+  uint16_t c = latchedColumn;
+  if ( c == _shownColumn ) return false;
+  //A Push Costing pushMicros Earns The Loop The Rest Of Its Share Before The Next
+  if ( now - _pushedAt < (unsigned long) pushMicros * 100 / maxShare ) return false;
+  _shownColumn = c;
+  render( c );
+  _pushedAt = now;
+  pushMicros = micros() - now;
+  frames++;
+  return true;
+}
+
+void PovRenderer::render(uint16_t column)
+{ //LED i Sits _ledColumn[i] Round From The Disc's Zero, So It Shows The World Column That Far Past The Phase
+  for (uint8_t i = 0; i < _leds; i++){
+    frame[i] = palette[ image[ (column + _ledColumn[i]) & (POV_COLUMNS - 1) ][ _ledRow[i] ] ];
+  }
+  if ( push != NULL ) push( pushTarget, frame, _leds );
+  _lit = true;
+}
+
+void PovRenderer::blank()
+{
+  memset( frame, 0, sizeof(frame) );
+  if ( push != NULL ) push( pushTarget, frame, _leds );
+  _lit = false;
+  _shownColumn = 0xFFFF;
+}
+
+void PovRenderer::clear(uint8_t colour)
+{
+  memset( image, colour, sizeof(image) );
+  _shownColumn = 0xFFFF;
+}
+
+void PovRenderer::arc(float from, float to, uint8_t colour, uint8_t row)
+{
+  uint16_t first = toUnits( from ) >> (32 - POV_COLUMN_BITS);
+  uint16_t last = toUnits( to ) >> (32 - POV_COLUMN_BITS);
+  for (uint16_t c = first; c != last; c = (c + 1) & (POV_COLUMNS - 1)){ image[c][row % POV_ROWS] = colour; }
+  image[last][row % POV_ROWS] = colour;
+  _shownColumn = 0xFFFF;
+}
+
+void PovRenderer::gradient(uint8_t row)
+{
+  for (uint16_t c = 0; c < POV_COLUMNS; c++){
+    image[c][row % POV_ROWS] = 1 + (uint32_t) c * (POV_PALETTE - 1) / POV_COLUMNS;
+  }
+  _shownColumn = 0xFFFF;
+}
@@ -0,0 +1,84 @@
+#include "application.h"
+
+#ifndef _INCL_POV
+#define _INCL_POV
+
+#define POV_COLUMN_BITS 8
+#define POV_COLUMNS (1 << POV_COLUMN_BITS) //Angular columns round the disc, 1.4 degrees each
+#define POV_ROWS 8                         //Rows per column, for layouts with LEDs at more than one radius
+#define POV_PALETTE 16
+#define POV_MAX_LEDS 64
+
+//Persistence Of Vision
+//The image lives in a table indexed by world angle. Between gyro samples the spin phase is extrapolated from
+//the last angle & rate. latch() runs from a timer interrupt (PovTimer) & only notes the column the phase is on,
+//show() runs between the loop's stages & pushes that column when it's new. The loop fills the spare of two phase
+//slots & flips to it, so the interrupt never sees half a sample. Pushes get at most maxShare of the loop, past
+//that rate columns are skipped rather than starving the physics
+//
+//Angles are 32 bit fixed point, 2^32 is a full turn, so wrapping is free
+class PovRenderer
+{
+public:
+  //Where Each LED Sits: Angle On The Disc (Degrees) & Which Image Row It Shows
+  void setLayout(uint8_t leds, const float *angles, const uint8_t *rows = NULL);
+  void ringLayout(uint8_t leds); //Evenly round the rim, all on row 0
+
+  //Spin Phase, From The Physics Loop Each Sample
+  void setPhase(float angle, float rate, unsigned long now); //Degrees, degrees per second, micros
+  uint32_t phase(unsigned long now);
+  uint16_t column(unsigned long now) { return phase( now ) >> (32 - POV_COLUMN_BITS); };
+  bool spinning() { return abs( _slots[_live].rate ) >= _slots[_live].minRate; };
+  bool running() { return enabled && spinning(); };
+
+  //Interrupt: Note The Column For now. True When It Moved
+  bool latch(unsigned long now);
+  //Loop: Push The Latched Column If It's New & The Strip's Share Allows, Blank Once When The Spin Drops Out
+  bool show(unsigned long now);
+
+  //Image
+  void clear(uint8_t colour = 0);
+  void set(uint16_t column, uint8_t row, uint8_t colour) { image[column & (POV_COLUMNS - 1)][row] = colour; };
+  void arc(float from, float to, uint8_t colour, uint8_t row = 0); //Degrees, world frame
+  void gradient(uint8_t row = 0); //Palette 1.. round the turn, 0 is left as off
+
+  uint8_t image[POV_COLUMNS][POV_ROWS];
+  uint32_t palette[POV_PALETTE]; //0xRRGGBB, 0 stays black
+
+  //Frame Output
+  uint32_t frame[POV_MAX_LEDS];
+  void (*push)(void *target, const uint32_t *frame, uint8_t leds) = NULL;
+  void *pushTarget = NULL;
+
+  volatile bool enabled = false;
+  float minRate = 360;      //deg/s, slower than a turn a second & it just looks like flicker
+  uint8_t maxShare = 25;    //% of the loop's time pushes may take
+  uint16_t pushMicros = 0;  //How long the last frame took to go out
+  volatile uint16_t latchedColumn = 0xFFFF;
+  volatile uint32_t latches = 0; //Columns stepped onto
+  volatile uint32_t polls = 0;   //Timer ticks
+  uint32_t frames = 0;           //Pushed to the strip
+
+private:
+  void render(uint16_t column);
+  void blank();
+
+  uint8_t _leds = 0;
+  uint16_t _ledColumn[POV_MAX_LEDS]; //Angle on the disc, in columns
+  uint8_t _ledRow[POV_MAX_LEDS];
+
+  //Last Sample, Double Buffered Against The Interrupt
+  struct PhaseSlot {
+    uint32_t phase;
+    int32_t rate;    //Angle units per microsecond
+    int32_t minRate;
+    unsigned long at;
+  };
+  PhaseSlot _slots[2] = {};
+  volatile uint8_t _live = 0;
+  unsigned long _pushedAt = 0;
+  uint16_t _shownColumn = 0xFFFF;
+  bool _lit = false;
+};
+
+#endif
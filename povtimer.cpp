@@ -0,0 +1,39 @@
+#include "povtimer.h"
+
+static PovRenderer *_renderer = NULL;
+
+//The System Handler Has Already Checked & Cleared The Update Flag
+static void povTick()
+{
+  _renderer -> latch( micros() );
+}
+
+void PovTimer::begin(PovRenderer &renderer, uint16_t tickMicros)
+{
+  _renderer = &renderer;
+  RCC_APB1PeriphClockCmd( RCC_APB1Periph_TIM4, ENABLE );
+
+  TIM_TimeBaseInitTypeDef base;
+  TIM_TimeBaseStructInit( &base );
+  base.TIM_Prescaler = SystemCoreClock / 2 / 1000000 - 1; //APB1 Timers Run At Half The Core, Count Micros
+  base.TIM_Period = tickMicros - 1;
+  base.TIM_CounterMode = TIM_CounterMode_Up;
+  TIM_TimeBaseInit( TIM4, &base );
+
+  attachSystemInterrupt( SysInterrupt_TIM4_Update, &povTick );
+  NVIC_InitTypeDef nvic;
+  nvic.NVIC_IRQChannel = TIM4_IRQn;
+  nvic.NVIC_IRQChannelPreemptionPriority = 10;
+  nvic.NVIC_IRQChannelSubPriority = 0;
+  nvic.NVIC_IRQChannelCmd = ENABLE;
+  NVIC_Init( &nvic );
+  TIM_ITConfig( TIM4, TIM_IT_Update, ENABLE );
+}
+
+void PovTimer::run(bool on)
+{
+  if ( on == _running || _renderer == NULL ) return;
+  _running = on;
+  TIM_SetCounter( TIM4, 0 );
+  TIM_Cmd( TIM4, on ? ENABLE : DISABLE );
+}
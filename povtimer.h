@@ -0,0 +1,24 @@
+#include "application.h"
+
+#ifndef _INCL_POVTIMER
+#define _INCL_POVTIMER
+
+#include "pov.h"
+
+#define POV_TICK 50 //Micros, well under a column at full spin so the latch lands close to the boundary
+
+//Calls PovRenderer::latch() From TIM4's Update Interrupt
+//TIM4 only has PWM on D0/D1, which are the MPU's I2C, so nothing else wants it. Priority sits below the system
+//& radio interrupts. The tick only notes a column, the strip is pushed from the loop. Idle unless POV is on
+class PovTimer
+{
+public:
+  void begin(PovRenderer &renderer, uint16_t tickMicros = POV_TICK);
+  void run(bool on); //Cheap to call every frame, the timer is only touched when this changes
+  bool running() { return _running; };
+
+private:
+  bool _running = false;
+};
+
+#endif
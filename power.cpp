@@ -0,0 +1,101 @@
+#include "power.h"
+#import "globals.h"
+
+void PowerState::enter()
+{
+  frisbeem._power.apply( profile );
+}
+
+void PowerSwitch::initialize()
+{
+  //Add States In Order Of ENUM (Because It Matters!)
+  addState(&activeState);
+  addState(&idleState);
+  addState(&dozeState);
+  addState(&sleepState);
+
+  //                   ODR    DLPF  Fusion  FPS  Bright Tel  WiFi       Delay  Step Down
+  activeState.profile = { 0,  3,    1.0f,   20,  100,   10,  WIFI_KEEP, 0,     10000 };  //1kHz, 41Hz
+  idleState.profile   = { 4,  3,    0.5f,   10,  40,    20,  WIFI_KEEP, 0,     60000 };  //200Hz
+  dozeState.profile   = { 19, 5,    0.25f,  2,   10,    100, WIFI_KEEP, 10,    300000 }; //50Hz, 10Hz
+  sleepState.profile  = { 99, 6,    0.1f,   0,   0,     0,   WIFI_OFF,  50,    0 };      //Between stops, see sleepUntilMotion
+}
+
+void PowerSwitch::update()
+{
+  unsigned long now = millis();
+  if ( !_applied ){ //Hardware Is Up Now, Put It In The Starting Mode
+    _applied = true;
+    modeSince = now;
+    lastActivity = now;
+    apply( profile() );
+  }
+
+  if ( _activity ){
+    _activity = false;
+    lastActivity = now;
+    if ( currentState != ACTIVE ) transitionTo( ACTIVE );
+    return;
+  }
+
+  if ( currentState == SLEEP ){ sleepUntilMotion(); return; }
+
+  unsigned long quiet = profile().stepDownAfter;
+  if ( quiet == 0 || now - modeSince < quiet || now - lastActivity < quiet ) return;
+  //Someone's Watching, Don't Go Dark On Them
+  if ( currentState >= IDLE && frisbeem._com.client.connected() ) return;
+  if ( currentState + 1 < NUM_POWER_MODES ) transitionTo( currentState + 1 );
+}
+
+void PowerSwitch::transitionTo( int nextState )
+{
+  if ( nextState == currentState || nextState >= NUM_POWER_MODES ) return;
+  bool waking = !awake() && nextState <= IDLE;
+  frisbeem._com.log("Power: "+ _states[nextState] -> type() );
+  uint8_t lastState = currentState;
+  uint32_t t0 = micros();
+  leave();
+  currentState = nextState;
+  modeSince = millis();
+  enter();
+  recordTransition( lastState, currentState, micros() - t0 );
+  //Low Power Fusion Drifts, Snap Back To The Measured Attitude If We Can
+  if ( waking ) frisbeem._mpu.reseedIfStill();
+}
+
+void PowerSwitch::apply(PowerProfile &p)
+{
+  frisbeem._mpu.setSampleRate( p.sampleDiv, p.dlpf );
+  frisbeem._mpu.fusionRateScale = p.fusionScale;
+  frisbeem.setFrameRate( p.ledFps );
+  frisbeem._lights._strip.setBrightness( p.brightness );
+  frisbeem._com.idleTelemetryDivider = p.telemetryDivider;
+
+  if ( p.wifi == WIFI_OFF && !frisbeem._com.wifiOff ){
+    frisbeem._com.wifiOff = true;
+    WiFi.off();
+  }
+  else if ( p.wifi == WIFI_KEEP && frisbeem._com.wifiOff ){
+    frisbeem._com.wifiOff = false;
+    WiFi.on();
+    WiFi.connect();
+    frisbeem._com.restartPending = true; //Server & mDNS Come Back Once WiFi Is Ready
+  }
+}
+
+void PowerSwitch::sleepUntilMotion()
+{ //Stop Mode, RAM & Pins Are Kept & We Carry On From Here
+  MPU_9250 &mpu = frisbeem._mpu;
+  mpu.enableWakeOnMotion( wakeThreshold, wakeOdr );
+  if ( sleepSeconds > 0 ){ System.sleep( mpu.intPin, RISING, sleepSeconds ); }
+  else { System.sleep( mpu.intPin, RISING ); }
+
+  bool moved = mpu.disableWakeOnMotion();
+  apply( profile() ); //Sample Rate Was Reset With The MPU
+  if ( moved ){
+    motionWakes++;
+    lastActivity = millis();
+    transitionTo( ACTIVE );
+  }
+  else { timeoutWakes++; } //One Loop Pass, Then Back Down
+}
@@ -0,0 +1,97 @@
+#include "application.h"
+
+#ifndef _INCL_POWER
+#define _INCL_POWER
+
+#include "state.h"
+
+enum WifiPolicy {
+  WIFI_KEEP = 0, //Stay connected, clients & mDNS keep working
+  WIFI_OFF       //Radio off, comes back (server & mDNS restarted) when a mode wants it
+};
+
+//Everything That Costs Power, Per Mode
+struct PowerProfile {
+  uint8_t sampleDiv;           //MPU ODR = 1kHz / (1 + sampleDiv)
+  uint8_t dlpf;                //DLPF_CFG for gyro & accel, bigger is narrower (& needs a lower ODR)
+  float fusionScale;           //Multiplies the fusionRates of the current motion profile
+  uint8_t ledFps;              //0 turns the strip off
+  uint8_t brightness;
+  uint8_t telemetryDivider;    //Idle telemetry every Nth opportunity, 0 for none
+  uint8_t wifi;                //WifiPolicy
+  uint16_t loopDelay;          //ms handed back to the system after each physics step
+  unsigned long stepDownAfter; //ms in this mode without activity before dropping one, 0 never
+};
+
+class PowerState: public State
+{
+public:
+  PowerProfile profile;
+  virtual void enter();
+  virtual String type() {return "PowerState";};
+};
+
+class ActivePowerState: public PowerState{virtual String type() {return "ActivePowerState";};};
+class IdlePowerState: public PowerState{virtual String type() {return "IdlePowerState";};};
+class DozePowerState: public PowerState{virtual String type() {return "DozePowerState";};};
+class SleepPowerState: public PowerState{virtual String type() {return "SleepPowerState";};};
+
+//Power Modes
+//ACTIVE & IDLE are awake, DOZE & SLEEP are low power. Any motion or client command goes straight to ACTIVE,
+//quiet time steps down one mode at a time. A connected client holds the disc awake (no lower than IDLE).
+//SLEEP stops the processor with the MPU on wake on motion, its interrupt pin brings the disc back
+class PowerSwitch: public StateSwitch
+{
+public:
+  PowerSwitch(){ initialize(); };
+  ~PowerSwitch(){};
+
+  enum PowerModes {
+    ACTIVE = 0,
+    IDLE,
+    DOZE,
+    SLEEP,
+    NUM_POWER_MODES
+  };
+
+  ActivePowerState activeState;
+  IdlePowerState idleState;
+  DozePowerState dozeState;
+  SleepPowerState sleepState;
+
+  bool awake() { return currentState <= IDLE; };
+  bool lightsOn() { return profile().ledFps > 0; };
+  PowerProfile& profile() { return stateNow() -> profile; };
+
+  //Activity, Cheap Enough To Call Every Sample
+  void noteMotion() { _activity = true; };
+  void noteClient() { _activity = true; };
+
+  void update(); //Once per frame
+  void apply(PowerProfile &p);
+
+  //SLEEP
+  uint16_t wakeThreshold = 100;   //mg of change between accel samples that wakes the disc
+  uint8_t wakeOdr = 5;            //LP_ACCEL_ODR, 7.8 Hz
+  uint16_t sleepSeconds = 600;    //Longest stop before the loop gets one pass, 0 for no limit
+  uint32_t motionWakes = 0, timeoutWakes = 0;
+
+  unsigned long modeSince = 0;    //millis()
+  unsigned long lastActivity = 0; //millis()
+
+  virtual void initialize();
+  virtual void transitionTo( int nextState );
+  virtual String type() {return "PowerSwitch";};
+  virtual PowerState* stateNow()
+  { //Only PowerStates Are Added Here
+    return static_cast<PowerState*>( _states[currentState] );
+  };
+
+private:
+  void sleepUntilMotion();
+
+  bool _activity = false;
+  bool _applied = false;
+};
+
+#endif
@@ -0,0 +1,136 @@
+#include "scripts.h"
+#import "games.h"
+#import "state.h"
+
+bool ScriptRunner::start(Game *game)
+{
+  for (uint8_t i = 0; i < MAX_SCRIPTS; i++){
+    ScriptFrame &frame = _frames[i];
+    if ( frame.running ) continue;
+    frame.game = game;
+    frame.line = 0;
+    frame.fired = AWAIT_NOTHING;
+    frame.pending = AWAIT_NOTHING;
+    frame.running = true;
+    resume( frame, AWAIT_NOTHING );
+    return true;
+  }
+  return false;
+}
+
+void ScriptRunner::stop(Game *game)
+{
+  for (uint8_t i = 0; i < MAX_SCRIPTS; i++){
+    if ( _frames[i].running && _frames[i].game == game ){ _frames[i].running = false; }
+  }
+  refresh();
+}
+
+void ScriptRunner::subscribe(EventBus &bus)
+{
+  bus.subscribe<TransitionEvent, ScriptRunner, &ScriptRunner::onTransition>( this );
+  bus.subscribe<ImpactEvent, ScriptRunner, &ScriptRunner::onNotify>( this );
+  bus.subscribe<GestureEvent, ScriptRunner, &ScriptRunner::onNotify>( this );
+}
+
+void ScriptRunner::resume(ScriptFrame &frame, uint16_t fired)
+{
+  uint16_t awaiting = frame.awaiting;
+  frame.fired = fired | frame.pending;
+  frame.awaiting = AWAIT_NOTHING;
+  if ( !frame.game -> runScript( frame ) ){ //Backed Off, Still Waiting. Some Conditions Only Fire Once, Hold On To Them
+    frame.awaiting = awaiting;
+    frame.pending = frame.fired;
+    _pending = true;
+    return;
+  }
+  frame.pending = AWAIT_NOTHING;
+  refresh();
+}
+
+void ScriptRunner::retry()
+{
+  _pending = false;
+  for (uint8_t i = 0; i < MAX_SCRIPTS; i++){
+    ScriptFrame &frame = _frames[i];
+    if ( frame.running && frame.pending ){ resume( frame, AWAIT_NOTHING ); }
+  }
+}
+
+void ScriptRunner::signal(uint16_t conditions)
+{
+  if ( !(awaiting & conditions) ) return;
+  for (uint8_t i = 0; i < MAX_SCRIPTS; i++){
+    ScriptFrame &frame = _frames[i];
+    if ( frame.running && (frame.awaiting & conditions) ){ resume( frame, frame.awaiting & conditions ); }
+  }
+}
+
+void ScriptRunner::timeouts(unsigned long t)
+{
+  for (uint8_t i = 0; i < MAX_SCRIPTS; i++){
+    ScriptFrame &frame = _frames[i];
+    if ( frame.running && frame.timed && (long)(t - frame.deadline) >= 0 ){ resume( frame, AWAIT_TIMEOUT ); }
+  }
+}
+
+void ScriptRunner::refresh()
+{ //Union Of What's Awaited & The Soonest Deadline
+  awaiting = AWAIT_NOTHING;
+  _timed = false;
+  for (uint8_t i = 0; i < MAX_SCRIPTS; i++){
+    ScriptFrame &frame = _frames[i];
+    if ( !frame.running ) continue;
+    awaiting |= frame.awaiting;
+    if ( frame.timed && ( !_timed || (long)(frame.deadline - _nextDeadline) < 0 ) ){
+      _nextDeadline = frame.deadline;
+      _timed = true;
+    }
+  }
+}
+
+void ScriptRunner::onTransition(TransitionEvent &transition)
+{
+  int fromState = transition.from, toState = transition.to;
+  uint16_t conditions = AWAIT_NOTHING;
+  if ( fromState == MotionSwitch::FLIGHT ){ _inFlight = false; _flightEnd = micros(); }
+  switch (toState)
+  {
+    case MotionSwitch::SPIN: conditions = AWAIT_SPIN; break;
+    case MotionSwitch::WINDUP: conditions = AWAIT_WINDUP; break;
+    case MotionSwitch::RELEASE: conditions = AWAIT_RELEASE | AWAIT_SPIN; break;
+    case MotionSwitch::FLIGHT:
+      conditions = AWAIT_FLIGHT;
+      if ( fromState != MotionSwitch::RELEASE ) conditions |= AWAIT_SPIN;
+      apogee.reset(); //New Flight, New Top
+      _inFlight = _flightOpen = true;
+      _flightStart = micros();
+      break;
+    case MotionSwitch::CATCH: conditions = AWAIT_CATCH; break;
+    case MotionSwitch::LANDED: conditions = AWAIT_LANDED; break;
+    case MotionSwitch::REST: conditions = AWAIT_REST; break;
+  }
+  signal( conditions );
+}
+
+void ScriptRunner::onNotify(ImpactEvent &impact)
+{
+  lastImpact = impact.impact;
+  signal( AWAIT_IMPACT );
+}
+
+void ScriptRunner::onNotify(GestureEvent &gesture)
+{
+  lastGesture = gesture.gesture;
+  signal( AWAIT_GESTURE );
+}
+
+void ScriptRunner::feedApogee(float z, unsigned long t)
+{
+  if ( !_inFlight && (long)(t - _flightEnd) > 0 ){ _flightOpen = false; return; } //Past The Landing
+  if ( apogee.update( z, t ) ){
+    apogeeHeight = apogee.detectedValue;
+    _flightOpen = false; //One Per Flight
+    signal( AWAIT_APOGEE );
+  }
+}
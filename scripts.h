@@ -0,0 +1,115 @@
+#include "application.h"
+
+#ifndef _INCL_SCRIPTS
+#define _INCL_SCRIPTS
+
+#include "detectors.h"
+#include "eventbus.h"
+
+class Game;
+
+#define MAX_SCRIPTS 4
+
+//Things A Script Can Wait For, OR Them Together To Wait For Any
+enum AwaitCondition {
+  AWAIT_NOTHING = 0,
+  AWAIT_SPIN    = 1 << 0,  //Entered SPIN, RELEASE or FLIGHT
+  AWAIT_WINDUP  = 1 << 1,
+  AWAIT_RELEASE = 1 << 2,
+  AWAIT_FLIGHT  = 1 << 3,
+  AWAIT_APOGEE  = 1 << 4,  //Top of the current flight, height in ScriptRunner::apogeeHeight
+  AWAIT_CATCH   = 1 << 5,
+  AWAIT_LANDED  = 1 << 6,
+  AWAIT_REST    = 1 << 7,
+  AWAIT_IMPACT  = 1 << 8,  //Any ImpactEvent, see ScriptRunner::lastImpact
+  AWAIT_GESTURE = 1 << 9,  //Any GestureEvent, see ScriptRunner::lastGesture
+  AWAIT_TIMEOUT = 1 << 15  //Only ever shows up in fired
+};
+
+//Where A Suspended Script Is & What Will Wake It
+struct ScriptFrame {
+  Game *game;
+  uint16_t line;          //Resume point, see SCRIPT_AWAIT
+  uint16_t awaiting;      //AwaitConditions
+  uint16_t fired;         //What woke it up last
+  uint16_t pending;       //Fired while the game was backed off, handed over on the next resume
+  unsigned long deadline; //micros(), only when timed
+  bool timed;
+  bool running;
+
+  void await(uint16_t conditions, unsigned long timeoutMicros)
+  {
+    awaiting = conditions;
+    timed = timeoutMicros > 0;
+    deadline = micros() + timeoutMicros;
+  };
+};
+
+//Stackless Coroutines For Game Logic
+//A Game's script(ScriptFrame &f) is written top to bottom & suspends at each SCRIPT_AWAIT. Locals don't survive a
+//suspend, keep anything needed across one in the Game. One SCRIPT_AWAIT per source line.
+//  SCRIPT_BEGIN(f);
+//  while (true){
+//    SCRIPT_AWAIT(f, AWAIT_FLIGHT, 0);
+//    SCRIPT_AWAIT(f, AWAIT_APOGEE | AWAIT_LANDED, 3000000);
+//    if ( f.fired & AWAIT_APOGEE ) ...
+//  }
+//  SCRIPT_END(f);
+#define SCRIPT_BEGIN(f) switch ( (f).line ) { case 0:
+#define SCRIPT_AWAIT(f, conditions, timeoutMicros) \
+  do { (f).await( (conditions), (timeoutMicros) ); (f).line = __LINE__; return; case __LINE__:; } while (0)
+#define SCRIPT_END(f) } (f).running = false; (f).awaiting = AWAIT_NOTHING
+
+//Holds The Frames & Resumes Them Only When Something They Await Happens
+//Nothing here runs per sample unless a script is timed or waiting on apogee, then tick() is a compare or a detector step
+class ScriptRunner
+{
+public:
+  ScriptRunner(): apogee(CH_XZ, 0.05)
+  { for (uint8_t i = 0; i < MAX_SCRIPTS; i++){ _frames[i].running = false; _frames[i].awaiting = _frames[i].pending = AWAIT_NOTHING; } };
+
+  bool start(Game *game); //Runs the script up to its first await
+  void stop(Game *game);
+  void subscribe(EventBus &bus);
+
+  //Wake Ups
+  void onTransition(TransitionEvent &transition);
+  void onNotify(ImpactEvent &impact);
+  void onNotify(GestureEvent &gesture);
+  void tick(MotionEvent &motion)
+  {
+    if ( _pending ) retry();
+    if ( _timed && (long)(motion.t - _nextDeadline) >= 0 ) timeouts( motion.t );
+  };
+  //Height Track For Apogee, Live Or Smoothed. A Lagging Track Is Held To The Flight's Own Span
+  void height(float z, unsigned long t)
+  {
+    if ( (awaiting & AWAIT_APOGEE) && _flightOpen && (long)(t - _flightStart) >= 0 ) feedApogee( z, t );
+  };
+
+  uint16_t awaiting = AWAIT_NOTHING; //Everything any frame is waiting for
+
+  //Payload Of The Last Wake Up
+  float apogeeHeight = 0;
+  ImpactRecord lastImpact;
+  uint8_t lastGesture = 0;
+
+private:
+  ScriptFrame _frames[MAX_SCRIPTS];
+  bool _timed = false;
+  bool _pending = false;           //Some frame holds conditions its game wasn't admitted for
+  unsigned long _nextDeadline = 0;
+  bool _inFlight = false;
+  bool _flightOpen = false;        //Heights up to the end of the last flight still count
+  unsigned long _flightStart = 0, _flightEnd = 0;
+  ExtremumDetector apogee;
+
+  void signal(uint16_t conditions);
+  void resume(ScriptFrame &frame, uint16_t fired);
+  void timeouts(unsigned long t);
+  void retry();
+  void feedApogee(float z, unsigned long t);
+  void refresh();
+};
+
+#endif
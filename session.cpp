@@ -0,0 +1,263 @@
+#include "session.h"
+
+////////////////////////////////////////////////////////////////////////////////
+//TRANSPORTS
+////////////////////////////////////////////////////////////////////////////////
+
+bool LoopbackTransport::begin()
+{
+  _id = _hub.attached++;
+  _read = _hub.written; //Only What's Sent From Now On
+  return true;
+}
+
+bool LoopbackTransport::send(const uint8_t *data, size_t size)
+{
+  if ( size > sizeof(SessionPacket) ) return false;
+  LoopbackHub::Frame &frame = _hub.frames[ _hub.written % LOOPBACK_PACKETS ];
+  frame.from = _id;
+  frame.size = size;
+  memcpy( frame.data, data, size );
+  _hub.written++;
+  return true;
+}
+
+int LoopbackTransport::receive(uint8_t *data, size_t size)
+{
+  if ( _hub.written - _read > LOOPBACK_PACKETS ){ //Lapped, Skip To The Oldest Still There
+    dropped += _hub.written - _read - LOOPBACK_PACKETS;
+    _read = _hub.written - LOOPBACK_PACKETS;
+  }
+  while ( _read != _hub.written ){
+    LoopbackHub::Frame &frame = _hub.frames[ _read++ % LOOPBACK_PACKETS ];
+    if ( frame.from == _id || frame.size > size ) continue; //Multicast Doesn't Echo Back Here
+    memcpy( data, frame.data, frame.size );
+    return frame.size;
+  }
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//SESSION
+////////////////////////////////////////////////////////////////////////////////
+
+void Session::begin(SessionTransport *transport, uint8_t discId)
+{
+  if ( _transport != NULL ) end();
+  _transport = transport;
+  disc = discId;
+  numPeers = 0;
+  _dirty = true;
+  hasClock = false;
+  clockOffset = 0;
+  _leader = NO_DISC;
+  resetSync();
+  if ( !_transport -> begin() ){ _transport = NULL; return; }
+  _began = _transport -> clock();
+}
+
+void Session::end()
+{
+  if ( _transport == NULL ) return;
+  _transport -> end();
+  _transport = NULL;
+  numPeers = 0;
+}
+
+void Session::update()
+{
+  if ( _transport == NULL ) return;
+
+  SessionPacket packet;
+  for (uint8_t i = 0; i < SESSION_DRAIN; i++){
+    int size = _transport -> receive( (uint8_t*) &packet, sizeof(packet) );
+    if ( size <= 0 ) break;
+    handle( packet, size );
+  }
+
+  unsigned long now = _transport -> clock();
+  expire( now );
+
+  //A New Leader Means A Different Clock To Follow
+  uint8_t lead = leader();
+  if ( lead != _leader ){
+    _leader = lead;
+    resetSync();
+  }
+  //Nobody Around Keeps A Clock & We're Lowest, Ours Starts The Session
+  if ( lead == disc && !hasClock && now - _began >= foundAfter ){
+    hasClock = true;
+    _dirty = true;
+  }
+
+  if ( now - _lastState >= heartbeat || ( _dirty && now - _lastState >= stateInterval ) ){ sendState( now ); }
+  //Ask Quickly Until We Have A Few Samples, Then Just Keep Up With Drift
+  if ( lead != disc ){
+    unsigned long interval = _numSamples < SYNC_SAMPLES ? syncInterval / 8 : syncInterval;
+    if ( now - _lastSync >= interval ){ requestSync( now ); }
+  }
+}
+
+void Session::setState(uint8_t phase, uint8_t power, uint16_t score, int16_t spin)
+{ //Spin Moves Every Sample, Only The Discrete Fields Count As A Change
+  if ( phase != _state.phase || power != _state.power || score != _state.score ) _dirty = true;
+  _state.phase = phase;
+  _state.power = power;
+  _state.score = score;
+  _state.spin = spin;
+}
+
+void Session::sendEvent(uint8_t kind, uint8_t detail, uint16_t value)
+{
+  if ( _transport == NULL ) return;
+  _out.event.kind = kind;
+  _out.event.detail = detail;
+  _out.event.value = value;
+  _out.event.at = clock();
+  transmit( SESSION_EVENT, sizeof(SessionEvent) );
+}
+
+uint8_t Session::leader()
+{ //Lowest That Keeps The Clock, Or Lowest Of All While Nobody Does
+  uint8_t lowest = disc;
+  uint8_t keeper = hasClock ? disc : NO_DISC;
+  for (uint8_t i = 0; i < numPeers; i++){
+    if ( peers[i].disc < lowest ) lowest = peers[i].disc;
+    if ( (peers[i].state.flags & SESSION_HAS_CLOCK) && peers[i].disc < keeper ) keeper = peers[i].disc;
+  }
+  return keeper != NO_DISC ? keeper : lowest;
+}
+
+SessionPeer* Session::peer(uint8_t discId)
+{
+  for (uint8_t i = 0; i < numPeers; i++){
+    if ( peers[i].disc == discId ) return &peers[i];
+  }
+  return NULL;
+}
+
+bool Session::transmit(uint8_t kind, size_t payload)
+{
+  _out.h.magic = SESSION_MAGIC;
+  _out.h.kind = kind;
+  _out.h.disc = disc;
+  _out.h.seq = _seq++;
+  _out.h.clock = clock();
+  if ( !_transport -> send( (uint8_t*) &_out, sizeof(SessionHeader) + payload ) ) return false;
+  sent++;
+  return true;
+}
+
+void Session::sendState(unsigned long now)
+{
+  _state.flags = hasClock ? SESSION_HAS_CLOCK : 0;
+  _out.state = _state;
+  if ( transmit( SESSION_STATE, sizeof(SessionState) ) ) _dirty = false;
+  _lastState = now;
+}
+
+void Session::requestSync(unsigned long now)
+{
+  _out.sync.to = _leader;
+  _out.sync.sent = now;
+  _out.sync.leaderClock = 0;
+  transmit( SESSION_SYNC_REQ, sizeof(SessionSync) );
+  _lastSync = now;
+}
+
+void Session::handle(SessionPacket &packet, int size)
+{
+  static const uint8_t payload[] = { sizeof(SessionState), sizeof(SessionEvent), sizeof(SessionSync), sizeof(SessionSync) };
+  if ( size < (int) sizeof(SessionHeader) || packet.h.magic != SESSION_MAGIC || packet.h.kind > SESSION_SYNC_RSP ||
+       size < (int)( sizeof(SessionHeader) + payload[packet.h.kind] ) ){
+    rejected++;
+    return;
+  }
+  if ( packet.h.disc == disc ) return; //Our Own, Looped Back By The Stack
+  received++;
+
+  SessionPeer *from = track( packet.h.disc, packet.h.seq, _transport -> clock() );
+  switch ( packet.h.kind ){
+    case SESSION_STATE:
+      if ( from != NULL ) from -> state = packet.state;
+      break;
+    case SESSION_EVENT:
+      if ( from == NULL ) break;
+      from -> lastEvent = packet.event;
+      if ( onEvent != NULL ) onEvent( eventTarget, *from, packet.event );
+      break;
+    default:
+      handleSync( packet );
+      break;
+  }
+}
+
+void Session::handleSync(SessionPacket &packet)
+{
+  if ( packet.sync.to != disc ) return;
+
+  if ( packet.h.kind == SESSION_SYNC_REQ ){ //We're Their Leader, Answer Straight Away. Without A Clock There's Nothing To Give
+    if ( !hasClock ) return;
+    _out.sync.to = packet.h.disc;
+    _out.sync.sent = packet.sync.sent;
+    _out.sync.leaderClock = clock();
+    transmit( SESSION_SYNC_RSP, sizeof(SessionSync) );
+    return;
+  }
+
+  if ( packet.h.disc != _leader ) return; //Answer From A Leader We've Since Dropped
+  unsigned long now = _transport -> clock();
+  uint32_t rtt = now - packet.sync.sent;
+  //Leader Stamped Its Clock Roughly Halfway Through The Round Trip
+  SyncSample &sample = _samples[ _numSamples % SYNC_SAMPLES ];
+  sample.offset = (long)( packet.sync.leaderClock + rtt / 2 - now );
+  sample.rtt = rtt;
+  _numSamples++;
+
+  //Queueing Only Ever Adds Delay, So The Fastest Round Trip Has The Least Error
+  uint8_t best = 0;
+  uint8_t count = _numSamples < SYNC_SAMPLES ? _numSamples : SYNC_SAMPLES;
+  for (uint8_t i = 1; i < count; i++){
+    if ( _samples[i].rtt < _samples[best].rtt ) best = i;
+  }
+  clockOffset = _samples[best].offset;
+  syncRtt = _samples[best].rtt;
+  if ( !hasClock ){ //Now We Can Lead Without Moving The Clock
+    hasClock = true;
+    _dirty = true;
+  }
+}
+
+SessionPeer* Session::track(uint8_t discId, uint8_t seq, unsigned long now)
+{
+  SessionPeer *p = peer( discId );
+  if ( p == NULL ){
+    if ( numPeers >= MAX_PEERS ) return NULL;
+    p = &peers[ numPeers++ ];
+    memset( p, 0, sizeof(SessionPeer) );
+    p -> disc = discId;
+  }
+  else {
+    uint8_t gap = seq - p -> seq - 1;
+    if ( gap < 0x80 ) p -> lost += gap; //Anything Bigger Is Reordering Or A Restart
+  }
+  p -> seq = seq;
+  p -> heard = now;
+  return p;
+}
+
+void Session::expire(unsigned long now)
+{
+  for (uint8_t i = 0; i < numPeers; ){
+    if ( now - peers[i].heard > peerTimeout ){ peers[i] = peers[ --numPeers ]; }
+    else { i++; }
+  }
+}
+
+void Session::resetSync()
+{
+  _numSamples = 0;
+  syncRtt = NO_RTT;
+  _lastSync = 0;
+  //Keep clockOffset, The Session Clock Shouldn't Jump Back To Local Time While We Resync
+}
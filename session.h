@@ -0,0 +1,204 @@
+#include "application.h"
+
+#ifndef _INCL_SESSION
+#define _INCL_SESSION
+
+#define SESSION_MAGIC 0xBE
+#define MAX_PEERS 8
+#define SESSION_DRAIN 8   //Packets handled per update, the rest wait for the next frame
+#define SYNC_SAMPLES 4    //Offset comes from the fastest round trip of the last few
+#define NO_DISC 0xFF
+#define NO_RTT 0xFFFFFFFF
+
+//Wire Format
+//Packed little endian structs, every disc is the same ARM part so nothing is byte swapped
+enum SessionPacketKind {
+  SESSION_STATE = 0, //Heartbeat & whenever our state changes
+  SESSION_EVENT,     //Throws, impacts & gestures as they happen
+  SESSION_SYNC_REQ,  //Follower -> leader, what time is it?
+  SESSION_SYNC_RSP   //Leader -> follower
+};
+
+enum SessionEventKind {
+  SESSION_THROW = 0,
+  SESSION_IMPACT,
+  SESSION_GESTURE
+};
+
+struct __attribute__((packed)) SessionHeader {
+  uint8_t magic;
+  uint8_t kind;
+  uint8_t disc;
+  uint8_t seq;
+  uint32_t clock; //Sender's session clock at send, micros
+};
+
+enum SessionStateFlags {
+  SESSION_HAS_CLOCK = 1 << 0 //Keeps the session clock, so it can lead
+};
+
+struct __attribute__((packed)) SessionState {
+  uint8_t phase;  //MotionSwitch state
+  uint8_t power;  //PowerSwitch mode
+  uint16_t score;
+  int16_t spin;   //deg/s
+  uint8_t flags;  //SessionStateFlags
+};
+
+struct __attribute__((packed)) SessionEvent {
+  uint8_t kind;
+  uint8_t detail; //Throw number, impact kind, gesture slot
+  uint16_t value; //Peak height cm, peak g x100, match distance
+  uint32_t at;    //Session clock
+};
+
+struct __attribute__((packed)) SessionSync {
+  uint8_t to;
+  uint32_t sent;        //Requester's local clock, echoed back
+  uint32_t leaderClock; //Filled in by the leader
+};
+
+struct __attribute__((packed)) SessionPacket {
+  SessionHeader h;
+  union {
+    SessionState state;
+    SessionEvent event;
+    SessionSync sync;
+  };
+};
+
+//How Packets Get Between Discs
+//Sends go to every disc in the session. receive() hands back the next packet or 0 when there's none waiting.
+//On the disc it's UDPTransport (udptransport.h), host tests use LoopbackTransport
+class SessionTransport
+{
+public:
+  virtual bool begin() = 0;
+  virtual void end(){};
+  virtual bool send(const uint8_t *data, size_t size) = 0;
+  virtual int receive(uint8_t *data, size_t size) = 0;
+  virtual unsigned long clock() { return micros(); }; //Local clock, micros
+};
+
+//N Simulated Discs In One Process
+//Every LoopbackTransport attached to the same hub sees the others' packets in order. Time is whatever the
+//driver sets hub.now to, plus a per disc offset so clock sync has some skew to work out
+#define LOOPBACK_PACKETS 32
+
+class LoopbackHub
+{
+public:
+  struct Frame {
+    uint8_t from;
+    uint8_t size;
+    uint8_t data[sizeof(SessionPacket)];
+  };
+
+  Frame frames[LOOPBACK_PACKETS];
+  uint32_t written = 0;
+  uint8_t attached = 0;
+  unsigned long now = 0;
+};
+
+class LoopbackTransport: public SessionTransport
+{
+public:
+  LoopbackTransport(LoopbackHub &hub, long offset = 0): clockOffset( offset ), _hub( hub ){};
+
+  virtual bool begin();
+  virtual bool send(const uint8_t *data, size_t size);
+  virtual int receive(uint8_t *data, size_t size);
+  virtual unsigned long clock() { return _hub.now + clockOffset; };
+
+  long clockOffset;
+  uint32_t dropped = 0; //Overwritten before we got to them
+
+private:
+  LoopbackHub &_hub;
+  uint8_t _id = 0;
+  uint32_t _read = 0;
+};
+
+struct SessionPeer {
+  uint8_t disc;
+  uint8_t seq;
+  uint16_t lost;          //Gaps in its sequence numbers
+  unsigned long heard;    //Local clock
+  SessionState state;
+  SessionEvent lastEvent;
+};
+
+//Local Disc To Disc Session
+//Discs find each other by their state heartbeats on the group, the session itself is advertised over mDNS
+//for clients. The lowest disc id that keeps the session clock is the leader, followers estimate their offset
+//from it with request/response round trips so light effects can run in lockstep. A disc only keeps the clock
+//once it has synced to someone who does, so a new lower id adopts the running clock before it takes over &
+//the session clock never jumps. When nobody has one, the lowest id starts it after listening for foundAfter
+class Session
+{
+public:
+  void begin(SessionTransport *transport, uint8_t discId);
+  void end();
+  void update();
+
+  //Our Side
+  void setState(uint8_t phase, uint8_t power, uint16_t score, int16_t spin);
+  void sendEvent(uint8_t kind, uint8_t detail, uint16_t value);
+
+  //Shared Clock
+  unsigned long clock() { return _transport -> clock() + clockOffset; };
+  uint32_t beat(uint32_t period) { return clock() % period; }; //Same on every synced disc
+  uint8_t leader();
+  bool synced() { return _transport != NULL && hasClock && ( leader() == disc || syncRtt != NO_RTT ); };
+
+  SessionPeer* peer(uint8_t discId);
+
+  //Peer Events, Called From update()
+  void (*onEvent)(void *target, SessionPeer &peer, SessionEvent &event) = NULL;
+  void *eventTarget = NULL;
+
+  uint8_t disc = NO_DISC;
+  SessionPeer peers[MAX_PEERS];
+  uint8_t numPeers = 0;
+
+  long clockOffset = 0;    //Session clock - local clock
+  uint32_t syncRtt = NO_RTT;
+  bool hasClock = false;   //clockOffset is the session's, not just our local clock
+
+  //Timing, Micros
+  unsigned long stateInterval = 50000;   //Fastest we send state changes
+  unsigned long heartbeat = 500000;      //State goes out at least this often
+  unsigned long syncInterval = 1000000;
+  unsigned long peerTimeout = 3000000;
+  unsigned long foundAfter = 1000000;    //Listen this long for a running session before starting one
+
+  uint32_t sent = 0;
+  uint32_t received = 0;
+  uint32_t rejected = 0;
+
+private:
+  void handle(SessionPacket &packet, int size);
+  void handleSync(SessionPacket &packet);
+  void sendState(unsigned long now);
+  void requestSync(unsigned long now);
+  void expire(unsigned long now);
+  void resetSync();
+  bool transmit(uint8_t kind, size_t payload);
+  SessionPeer* track(uint8_t discId, uint8_t seq, unsigned long now);
+
+  SessionTransport *_transport = NULL;
+  SessionPacket _out;
+  uint8_t _seq = 0;
+  SessionState _state;
+  bool _dirty = true;
+  unsigned long _lastState = 0;
+  unsigned long _lastSync = 0;
+  unsigned long _began = 0;
+  uint8_t _leader = NO_DISC;
+
+  struct SyncSample { long offset; uint32_t rtt; };
+  SyncSample _samples[SYNC_SAMPLES];
+  uint8_t _numSamples = 0;
+};
+
+#endif
@@ -0,0 +1,152 @@
+#include "smoother.h"
+
+//Symmetric 3x3 Matrices Are Stored As 00 01 02 11 12 22
+
+//Constant Acceleration Step Under White Jerk q. Also Leaves F P In FP (Row Major), The Backward Pass Needs It
+static void predict(const float *x, const float *P, float dt, float q, float *xp, float *Pp, float *FP)
+{
+  float h = 0.5f * dt * dt;
+  xp[0] = x[0] + x[1] * dt + x[2] * h;
+  xp[1] = x[1] + x[2] * dt;
+  xp[2] = x[2];
+
+  FP[0] = P[0] + dt * P[1] + h * P[2];  FP[1] = P[1] + dt * P[3] + h * P[4];  FP[2] = P[2] + dt * P[4] + h * P[5];
+  FP[3] = P[1] + dt * P[2];             FP[4] = P[3] + dt * P[4];             FP[5] = P[4] + dt * P[5];
+  FP[6] = P[2];                         FP[7] = P[4];                         FP[8] = P[5];
+
+  float d2 = dt * dt, d3 = d2 * dt;
+  Pp[0] = FP[0] + dt * FP[1] + h * FP[2] + q * d3 * d2 / 20.0f;
+  Pp[1] = FP[1] + dt * FP[2] + q * d2 * d2 / 8.0f;
+  Pp[2] = FP[2] + q * d3 / 6.0f;
+  Pp[3] = FP[4] + dt * FP[5] + q * d3 / 3.0f;
+  Pp[4] = FP[5] + q * d2 / 2.0f;
+  Pp[5] = FP[8] + q * dt;
+}
+
+//Scalar Measurement Of State Component k
+static void measure(float *x, float *P, uint8_t k, float value, float noise)
+{
+  static const uint8_t at[3][3] = { {0, 1, 2}, {1, 3, 4}, {2, 4, 5} };
+  float s = P[ at[k][k] ] + noise;
+  if ( s <= 0.0f ) return;
+  float p0 = P[ at[0][k] ], p1 = P[ at[1][k] ], p2 = P[ at[2][k] ];
+  float e = (value - x[k]) / s;
+  x[0] += p0 * e; x[1] += p1 * e; x[2] += p2 * e;
+  P[0] -= p0 * p0 / s; P[1] -= p0 * p1 / s; P[2] -= p0 * p2 / s;
+  P[3] -= p1 * p1 / s; P[4] -= p1 * p2 / s; P[5] -= p2 * p2 / s;
+}
+
+static bool invert(const float *A, float *I)
+{
+  I[0] = A[3] * A[5] - A[4] * A[4];
+  I[1] = A[2] * A[4] - A[1] * A[5];
+  I[2] = A[1] * A[4] - A[2] * A[3];
+  I[3] = A[0] * A[5] - A[2] * A[2];
+  I[4] = A[1] * A[2] - A[0] * A[4];
+  I[5] = A[0] * A[3] - A[1] * A[1];
+  float det = A[0] * I[0] + A[1] * I[1] + A[2] * I[2];
+  if ( det <= 0.0f ) return false;
+  for (uint8_t i = 0; i < 6; i++){ I[i] /= det; }
+  return true;
+}
+
+void TrajectorySmoother::reset(float z, float vz)
+{
+  _seq = 0;
+  _emit = 1;
+  _final = 1;
+  _passing = false;
+  _started = false;
+  _x[0] = z; _x[1] = vz; _x[2] = 0;
+}
+
+bool TrajectorySmoother::update(unsigned long t, float az, bool still, TrajectoryPoint &out)
+{
+  if ( !enabled ) return false;
+
+  if ( !_started )
+  { //First Sample, Start From The Seed
+    _started = true;
+    _P[0] = 0.01f; _P[1] = 0; _P[2] = 0; _P[3] = 0.1f; _P[4] = 0; _P[5] = accelNoise;
+  }
+  else
+  { //Predict Over dt
+    float xp[3], Pp[6], FP[9];
+    predict( _x, _P, (t - step( _seq ).t) / 1000000.0f, jerkNoise, xp, Pp, FP );
+    memcpy( _x, xp, sizeof(_x) );
+    memcpy( _P, Pp, sizeof(_P) );
+  }
+  measure( _x, _P, 2, az * gravity, accelNoise );
+  if ( still ){ measure( _x, _P, 1, 0.0f, stillNoise ); }
+
+  //Out Of Window: Drop The Oldest Unsent Step. A Pass Reaching Down That Far Can't Finish
+  if ( _seq + 1 - _emit >= SMOOTHER_WINDOW ){
+    _emit++;
+    dropped++;
+    if ( _final < _emit ) _final = _emit;
+    _passing = false;
+  }
+
+  Step &s = step( ++_seq );
+  s.t = t;
+  memcpy( s.x, _x, sizeof(_x) );
+  memcpy( s.P, _P, sizeof(_P) );
+
+  if ( _passing ){ passStep(); }
+  else if ( _seq > _final && ( t - step( _final ).t >= 2 * lagMicros || _seq - _final >= 2 * SMOOTHER_MAX_LAG ) ){ startPass(); }
+
+  if ( _emit == _final ) return false;
+  Step &e = step( _emit++ );
+  out.t = e.t;
+  out.z = e.x[0];
+  out.vz = e.x[1];
+  return true;
+}
+
+void TrajectorySmoother::startPass()
+{ //Newest Filtered State Is Already Smoothed
+  _passing = true;
+  _top = _seq;
+  _cursor = _seq - 1;
+  _passFinal = 0;
+  memcpy( _xs, step( _top ).x, sizeof(_xs) );
+  passStep();
+}
+
+void TrajectorySmoother::passStep()
+{
+  unsigned long topT = step( _top ).t;
+  for (uint8_t n = 0; n < SMOOTHER_PASS_STEPS; n++)
+  {
+    if ( _cursor < _final )
+    { //Down To The Last Pass's Finals, Hand Over What This One Settled
+      _passing = false;
+      if ( _passFinal >= _final ){
+        _final = _passFinal + 1;
+        lookahead = topT - step( _passFinal ).t;
+        lagLimited = lookahead < lagMicros;
+      }
+      return;
+    }
+
+    //xs = xf + Pf F' Pp^-1 (xs(next) - xp(next))
+    Step &cur = step( _cursor );
+    float xp[3], Pp[6], FP[9], I[6];
+    predict( cur.x, cur.P, (step( _cursor + 1 ).t - cur.t) / 1000000.0f, jerkNoise, xp, Pp, FP );
+    if ( invert( Pp, I ) ){
+      float e0 = _xs[0] - xp[0], e1 = _xs[1] - xp[1], e2 = _xs[2] - xp[2];
+      float g0 = I[0] * e0 + I[1] * e1 + I[2] * e2;
+      float g1 = I[1] * e0 + I[3] * e1 + I[4] * e2;
+      float g2 = I[2] * e0 + I[4] * e1 + I[5] * e2;
+      for (uint8_t i = 0; i < 3; i++){ _xs[i] = cur.x[i] + FP[i] * g0 + FP[3 + i] * g1 + FP[6 + i] * g2; }
+    }
+    else { memcpy( _xs, cur.x, sizeof(_xs) ); }
+
+    //Far Enough Below The Top, Nothing Later Changes It
+    if ( _top - _cursor >= SMOOTHER_MAX_LAG || topT - cur.t >= lagMicros ){
+      if ( _passFinal == 0 ) _passFinal = _cursor;
+      memcpy( cur.x, _xs, sizeof(_xs) );
+    }
+    _cursor--;
+  }
+}
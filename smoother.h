@@ -0,0 +1,73 @@
+#include "application.h"
+
+#ifndef _INCL_SMOOTHER
+#define _INCL_SMOOTHER
+
+#define SMOOTHER_WINDOW 192                    //Filtered steps held behind the live estimate
+#define SMOOTHER_MAX_LAG (SMOOTHER_WINDOW / 5) //Most samples of lookahead the window can hold, see below
+#define SMOOTHER_PASS_STEPS 2                  //Backward steps per sample
+
+//Smoothed Vertical Trajectory Point
+struct TrajectoryPoint {
+  unsigned long t; //micros() of the sample this point refines
+  float z;         //m
+  float vz;        //m/s
+};
+
+//Fixed Lag Rauch-Tung-Striebel Smoother For Height
+//A Kalman filter over [z, vz, az] with a white jerk model. Its measurements are the ones that carry their own
+//information: Awrld.z every sample, & vz = 0 while the disc is still. The live X.z & V.z are just Awrld.z
+//integrated, so they're only used to seed z & vz.
+//
+//The backward pass is spread over the samples: once the oldest unrefined step is two lags behind the newest, a
+//pass starts down from the newest, SMOOTHER_PASS_STEPS steps per sample. When it's done every step at least
+//lagMicros behind where it began is final & they're emitted one per sample. Cost per sample is constant, points
+//come out two to three lags behind the live one, each refined with at least lagMicros (or SMOOTHER_MAX_LAG
+//samples, whichever comes first) of what happened after it
+class TrajectorySmoother
+{
+public:
+  //Parameters
+  bool enabled = false;
+  unsigned long lagMicros = 30000;   //Lookahead each point is refined with
+  float jerkNoise = 2000.0;          //Process noise, (m/s^3)^2 per Hz
+  float accelNoise = 0.5;            //Awrld.z measurement noise, (m/s^2)^2
+  float stillNoise = 0.0001;         //Zero velocity pseudo measurement noise, (m/s)^2
+  float gravity = 9.81;              //Awrld is in g's
+
+  //Outputs
+  bool lagLimited = false;           //The last pass ran out of window before lagMicros
+  unsigned long lookahead = 0;       //Least lookahead of the last pass's points, micros
+  uint32_t dropped = 0;              //Steps overwritten before they were emitted
+
+  //Feed One Live Sample, Returns True When A Refined Point Is Ready In out
+  bool update(unsigned long t, float az, bool still, TrajectoryPoint &out);
+  void reset(float z = 0, float vz = 0); //Height & vertical speed to start from
+
+private:
+  //Filtered Moments Kept For The Backward Pass. Once a step is final its x holds the smoothed state
+  struct Step {
+    unsigned long t;
+    float x[3];       //z, vz, az
+    float P[6];       //P00 P01 P02 P11 P12 P22
+  };
+
+  Step& step(uint32_t seq) { return _window[ seq % SMOOTHER_WINDOW ]; };
+  void startPass();
+  void passStep();
+
+  Step _window[SMOOTHER_WINDOW];
+  uint32_t _seq = 0;     //Newest step
+  uint32_t _emit = 1;    //Next step to emit
+  uint32_t _final = 1;   //First step that isn't final yet
+  bool _started = false;
+  float _x[3];
+  float _P[6];
+
+  //Backward Pass In Progress
+  bool _passing = false;
+  uint32_t _top, _cursor, _passFinal;
+  float _xs[3];          //Smoothed state of the step above the cursor
+};
+
+#endif
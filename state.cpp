@@ -5,53 +5,202 @@
 MotionData motionData = MotionData();
 
 void StateSwitch::handleInput( Event &event)
-{ frisbeem._com.log("Switch Handiling Input: "+event.type());
+{ frisbeem._com.log("Switch Handiling Input: "+String(event.type()));
   State *s = stateNow();
   event.visit( s );
 }
 
 void StateSwitch::transitionTo( int nextState )
 {
+  uint8_t lastState = currentState;
   frisbeem._com.log("Leaving: "+ stateNow() -> type() );
+  uint32_t t0 = micros();
   leave();
   currentState = nextState;
-  frisbeem._com.log("Entering: "+ stateNow() -> type() );
   enter();
+  recordTransition( lastState, currentState, micros() - t0 );
+  frisbeem._com.log("Entering: "+ stateNow() -> type() );
 };
 
+void StateSwitch::resetMetrics()
+{
+  memset( &metrics, 0, sizeof(metrics) );
+  metrics.enteredAt = millis();
+}
+
+void StateSwitch::recordTransition( uint8_t from, uint8_t to, uint32_t hookMicros )
+{
+  unsigned long now = millis();
+  if ( from < METRIC_STATES ){
+    metrics.residencyMs[from] += now - metrics.enteredAt;
+    if ( to < METRIC_STATES ) metrics.transitions[from][to]++;
+  }
+  metrics.enteredAt = now;
+
+  StateMetrics::Transition &entry = metrics.recent[ metrics.count & (TRANSITION_LOG - 1) ];
+  entry.from = from;
+  entry.to = to;
+  entry.t = now;
+  metrics.count++;
+
+  metrics.hookMicros += hookMicros;
+  if ( hookMicros > metrics.hookMaxMicros ) metrics.hookMaxMicros = hookMicros;
+}
+
+uint32_t StateSwitch::residency( uint8_t state )
+{
+  if ( state >= METRIC_STATES ) return 0;
+  uint32_t ms = metrics.residencyMs[state];
+  if ( state == currentState ) ms += millis() - metrics.enteredAt;
+  return ms;
+}
+
+StateMetrics::Transition* StateSwitch::recentTransition( uint8_t age )
+{
+  if ( age >= TRANSITION_LOG || age >= metrics.count ) return NULL;
+  return &metrics.recent[ (metrics.count - 1 - age) & (TRANSITION_LOG - 1) ];
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 //MOTION STATES
 ////////////////////////////////////////////////////////////////////////////////
 
+//Phase Guards
+static bool spinning( const PhaseFeatures &f ){ return f.spinning; }
+static bool windingUp( const PhaseFeatures &f ){ return f.windup; }
+static bool settled( const PhaseFeatures &f ){ return f.settled; }
+static bool stirred( const PhaseFeatures &f ){ return f.stirred; }
+static bool spunDown( const PhaseFeatures &f ){ return f.spunDown; }
+static bool spunDownSettled( const PhaseFeatures &f ){ return f.spunDown && f.settled; }
+static bool caught( const PhaseFeatures &f ){ return f.impact && f.impactKind == IMPACT_CATCH; }
+static bool hitSomething( const PhaseFeatures &f ){ return f.impact && f.impactKind != IMPACT_CATCH; }
+
+//Grouped By from, First Passing Row Wins
+const PhaseTransition MotionSwitch::transitions[] = {
+  { REST,    SPIN,    &spinning,        &MotionSwitch::settleDwell },
+  { REST,    MOTION,  &stirred,         &MotionSwitch::settleDwell },
+
+  { MOTION,  WINDUP,  &windingUp,       NULL },
+  { MOTION,  SPIN,    &spinning,        &MotionSwitch::settleDwell },
+  { MOTION,  REST,    &settled,         &MotionSwitch::settleDwell },
+
+  { SPIN,    REST,    &spunDownSettled, &MotionSwitch::settleDwell },
+  { SPIN,    MOTION,  &spunDown,        &MotionSwitch::settleDwell },
+
+  { WINDUP,  RELEASE, &spinning,        NULL },
+  { WINDUP,  MOTION,  NULL,             &MotionSwitch::windupTimeout }, //Just A Wave
+
+  { RELEASE, FLIGHT,  NULL,             &MotionSwitch::releaseDwell },
+
+  { FLIGHT,  CATCH,   &caught,          NULL },
+  { FLIGHT,  LANDED,  &hitSomething,    NULL },
+  { FLIGHT,  LANDED,  &spunDown,        NULL }, //Came Down Somewhere Soft
+
+  { CATCH,   REST,    &settled,         &MotionSwitch::catchDwell },
+  { CATCH,   MOTION,  NULL,             &MotionSwitch::catchDwell },
+
+  { LANDED,  REST,    &settled,         NULL },
+  { LANDED,  MOTION,  NULL,             &MotionSwitch::catchDwell }, //Picked Back Up
+};
+const uint8_t MotionSwitch::numTransitions = sizeof(MotionSwitch::transitions) / sizeof(PhaseTransition);
+
 void MotionSwitch::initialize()
 {
   //Add States In Order Of ENUM (Because It Matters!)
-  _states.push_back(&restState);
-  _states.push_back(&motionState);
-  _states.push_back(&spinState);
+  addState(&restState);
+  addState(&motionState);
+  addState(&spinState);
+  addState(&windupState);
+  addState(&releaseState);
+  addState(&flightState);
+  addState(&catchState);
+  addState(&landedState);
+
+  //Index The Table By Phase
+  uint8_t row = 0;
+  for (uint8_t phase = 0; phase < NUM_MOTION_STATES; phase++){
+    rowStart[phase] = row;
+    while ( row < numTransitions && transitions[row].from == phase ){ row++; }
+  }
+  rowStart[NUM_MOTION_STATES] = row;
 }
 
 void MotionSwitch::handleInput( Event &event)
-{ frisbeem._com.log("MotionSwitch Handiling Input: "+event.type());
+{ frisbeem._com.log("MotionSwitch Handiling Input: "+String(event.type()));
   MotionState *s = stateNow();
   event.visit( s );
 }
 
 void MotionSwitch::handleInput( MotionEvent &motion)
-{ frisbeem._com.log("MotionSwitch Handiling Motion Input: "+motion.type());
-  MotionState *s = stateNow();
-  motion.visit( s );
+{ //Hot Path, Runs Every Sample Off The EventBus. No Logging Here
+  uint8_t next = nextPhase( motion );
+  if ( next != currentState ){
+    phaseSince = motion.t;
+    transitionTo( next );
+  }
+  stateNow() -> handleInput( motion );
+}
+
+void MotionSwitch::trackHistory( MotionHistory &history )
+{ //Same Channel The MPU's Rest Flag Comes From
+  _settleWindow = history.track( CH_ALXY, restDebounce );
+  _stirWindow = history.track( CH_ALXY, moveDebounce );
+  _history = ( _settleWindow < 0 || _stirWindow < 0 ) ? NULL : &history;
+}
+
+PhaseFeatures MotionSwitch::features( MotionEvent &motion )
+{
+  MPU_9250 &mpu = frisbeem._mpu;
+  PhaseFeatures f;
+  float spinThreshold = restState._motionData -> spinThreshold;
+  float spin = fabs( motion.G.z );
+  f.spinning = spin > spinThreshold;
+  f.spunDown = spin < spinThreshold - spinHysteresis;
+  f.windup = mpu.Alin.getMagnitude() > windupAccel;
+
+  //Debounce The Rest Flag Both Ways: Every Sample Across The Window Has To Agree
+  WindowStats settle, stir;
+  if ( _history != NULL && _history -> windowStats( _settleWindow, settle ) && _history -> windowStats( _stirWindow, stir ) ){
+    f.settled = settle.full && settle.max < mpu.Axy_MagThresh;
+    f.stirred = stir.full && stir.min >= mpu.Axy_MagThresh;
+  }
+  else { //No History, Go On The Raw Flag
+    f.settled = mpu.rest;
+    f.stirred = !mpu.rest;
+  }
+
+  f.impact = mpu.impact.count != _lastImpactCount;
+  f.impactKind = mpu.impact.last.kind;
+  _lastImpactCount = mpu.impact.count;
+  return f;
+}
+
+uint8_t MotionSwitch::nextPhase( MotionEvent &motion )
+{
+  PhaseFeatures f = features( motion );
+  unsigned long inPhase = motion.t - phaseSince;
+  for (uint8_t row = rowStart[currentState]; row < rowStart[currentState + 1]; row++){
+    const PhaseTransition &t = transitions[row];
+    if ( t.dwell != NULL && inPhase < this ->* t.dwell ) continue;
+    if ( t.guard == NULL || t.guard( f ) ) return t.to;
+  }
+  return currentState;
 }
 
 void MotionSwitch::transitionTo( int nextState )
 {
   if (nextState != currentState)
   {
-    frisbeem._com.log("Leaving: "+ stateNow() -> type() );
+    int lastState = currentState;
+    //No Log Strings Here, This Runs On The Sample Path
+    uint32_t t0 = micros();
     leave();
     currentState = nextState;
-    frisbeem._com.log("Entering: "+ stateNow() -> type() );
     enter();
+    recordTransition( lastState, currentState, micros() - t0 );
+    //Throw Metrics, Then Scripts, See The New Phase
+    TransitionEvent transition( lastState, currentState, micros() );
+    frisbeem._bus.publish( transition );
   }
 };
 
@@ -63,33 +212,15 @@ MotionState::MotionState()
 
 void MotionState::handleInput( MotionEvent &motion )
 {
-  frisbeem._com.log("MotionState Handiling Motion Input: "+motion.type());
   _motionEvent = &motion;
-  //Check Spin
-  if ( motion.G.z > ( _motionData -> spinThreshold) )
-  {
-    frisbeem._motionState.transitionTo(MotionSwitch::SPIN);
-  }
-  else if( frisbeem._mpu.rest ) //Check If Resting
-  {
-    frisbeem._motionState.transitionTo(MotionSwitch::REST);
-  }
-  else{
-    frisbeem._motionState.transitionTo(MotionSwitch::MOTION);
-  }
+  //Phase Transitions Are Decided Up Front By MotionSwitch::nextPhase
 
-  //Update State
+  //Update State, Past Samples Are In frisbeem._history
   update();
-  //Set Values Going Out
-  Glast = motion.G;
-  Alast = motion.A;
-  Vlast = motion.V;
-  Xlast = motion.X;
 }
 
 void MotionState::update()
-  { //Initialize and do some physics math
-      frisbeem._com.log("MotionState Updating..");
+  { //Initialize and do some physics math. Runs Every Sample Off The Bus, No Logging
       _motionData -> now = micros();
       _motionData -> newOmega = _motionEvent -> G.z;//();
       _motionData -> dOmega = _motionData -> newOmega - _motionData -> lastOmega;
@@ -104,42 +235,7 @@ void MotionState::update()
 
       //Serial.print("Torque \t");Serial.println(torque);
       //Serial.print("Omega \t");Serial.println(newOmega);
-      if (_motionData ->newOmega > 200){ //Airborne
-          _motionData ->stationaryCount = 0;
-          _motionData ->moving = true;
-          //Serial.println("Moving...");
-          _motionData ->sleepModeActivated = false;
-      }
-      else{
-        //Serial.println("Stationary...");
-        _motionData ->stationaryCount++;
-        _motionData ->moving = false;
-        if (_motionData ->stationaryCount > _motionData ->sleepThreshold){
-          //Serial.println("Greater Than threshold");
-         if (_motionData ->stationaryCount > _motionData ->stationaryReset){
-           _motionData ->stationaryCount = 0;
-         }
-         _motionData ->stationaryCount = _motionData ->stationaryCount + 10;
-         _motionData ->sleepModeActivated = true;
-        }
-        else{
-          //Serial.print("stationaryCount");Serial.println( stationaryCount);
-          _motionData ->sleepModeActivated = false;
-
-        }
-      }
-      if (_motionData ->sleepModeActivated){
-       //Turn Off Lights. Switch Arduino to Low Power Consumption.
-       frisbeem._com.log("Sleep Mode");
-      }
-      else {
-        if (_motionData ->moving) { //Rainbow Pattern
-          frisbeem._com.log("Airborne");
-        }
-        else{ //Stationary
-          frisbeem._com.log("Stationary");
-        }
-      }
+      //Sleep & Lights Follow The Power Profile, Not A Count Of Still Samples
       //delay(50);//temp
       //Setup For Next Update
       _motionData ->lastTime = _motionData ->now;
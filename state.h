@@ -1,13 +1,17 @@
 #include"application.h"
+
+#ifndef _INCL_STATE
+#define _INCL_STATE
+
 #undef min
 #undef max
-#include <vector>
 #import "3dmath.h"
 //using namespace std;
 
 //Predeclare
 class Event;
 class MotionEvent;
+class MotionHistory;
 //class VectorFloat;
 
 #define MAX_STATES 50 //'Murica
@@ -40,16 +44,44 @@ public:
   virtual String type() {return "state";};
 };
 
+#define METRIC_STATES 8   //States past this aren't tracked
+#define TRANSITION_LOG 16 //Power Of Two
+
+//Where A StateSwitch Spends Its Time
+//Fixed counters touched once per transition, nothing is formatted until someone asks over COM
+struct StateMetrics {
+  struct Transition {
+    uint8_t from, to;
+    unsigned long t; //millis()
+  };
+
+  uint32_t residencyMs[METRIC_STATES];                //Finished stints only, see StateSwitch::residency()
+  uint16_t transitions[METRIC_STATES][METRIC_STATES]; //[from][to]
+  uint32_t count;
+  uint32_t hookMicros, hookMaxMicros;                 //leave() + enter(), total & worst
+  Transition recent[TRANSITION_LOG];
+  unsigned long enteredAt;                            //millis() the current state was entered
+};
+
 //Container For Many States
 class StateSwitch: public State
 {
   //Class that passes argument to current state
 public:
-  StateSwitch(){ initialize(); };
+  StateSwitch(){ initialize(); resetMetrics(); };
   ~StateSwitch(){};
 
-  int currentState = 0;
-  std::vector<State*>  _states;
+  //Dense State Index Into A Fixed Table, Substates Are Added In Enum Order
+  uint8_t currentState = 0;
+  uint8_t numStates = 0;
+  State* _states[MAX_STATES];
+  bool addState( State *state )
+  {
+    if ( numStates >= MAX_STATES ) return false;
+    _states[ numStates++ ] = state;
+    return true;
+  };
+
   //Important Funcitons
   virtual void initialize(){};
   virtual void handleInput( Event &event);
@@ -58,9 +90,16 @@ public:
 
   virtual State* stateNow()
   {
-    return _states.at(currentState);
+    return _states[currentState];
   };
 
+  //Residency & Transition Metrics
+  StateMetrics metrics;
+  void resetMetrics();
+  void recordTransition( uint8_t from, uint8_t to, uint32_t hookMicros );
+  uint32_t residency( uint8_t state ); //ms, including the current stint
+  StateMetrics::Transition* recentTransition( uint8_t age ); //age 0 is the latest, NULL past what's logged
+
   //Not Implemented Yet
   virtual void update() {
     _states[ currentState ] -> update();
@@ -95,13 +134,6 @@ class MotionData
   //Spin threshold
   float spinThreshold = 200;
 
-  //Bullshit For Functionality... send out to other classes
-  int stationaryCount;
-  bool moving = false;
-  bool sleepModeActivated = false;
-  unsigned long sleepThreshold = 15000;
-  unsigned long stationaryReset = -10;
-
   //Torque Parameters
   float dOmegaDt, _torque, torque, dOmega, newOmega, lastOmega;
   String msg = "Hello is motion";
@@ -125,9 +157,6 @@ public:
   virtual void enter(){};
   virtual void leave(){};
 
-  //Store Last Values
-  VectorFloat Glast, Alast, Vlast, Xlast;
-
   //Need To Define Method All Event Types... C++ cannot double dispatch so
   //It helps to overload the state event handlers... it can't do both at once
   virtual String type() {return "MotionState";};
@@ -138,6 +167,36 @@ class RestState: public MotionState{virtual String type() {return "RestState";};
 class DynamicMotionState: public MotionState{virtual String type() {return "DynamicMotionState";};};
 class SpinState: public MotionState{virtual String type() {return "SpinState";};};
 
+//Throw Phases
+class WindupState: public MotionState{virtual String type() {return "WindupState";};};
+class ReleaseState: public MotionState{virtual String type() {return "ReleaseState";};};
+class FlightState: public MotionState{virtual String type() {return "FlightState";};};
+class CatchState: public MotionState{virtual String type() {return "CatchState";};};
+class LandedState: public MotionState{virtual String type() {return "LandedState";};};
+
+//Per Sample Inputs To The Phase Guards, Computed Once In MotionSwitch::features()
+struct PhaseFeatures {
+  bool spinning;      //Spin above spinThreshold
+  bool spunDown;      //Spin below spinThreshold - spinHysteresis
+  bool windup;        //Linear acceleration above windupAccel
+  bool settled;       //At rest for restDebounce
+  bool stirred;       //Out of rest for moveDebounce
+  bool impact;        //New impact since last sample
+  uint8_t impactKind;
+};
+
+class MotionSwitch;
+typedef bool (*PhaseGuard)(const PhaseFeatures &f);
+
+//One Row Of The Phase Table
+//Fires when the current phase is from, it has been held for at least dwell & guard passes (NULL guard always passes)
+struct PhaseTransition {
+  uint8_t from;
+  uint8_t to;
+  PhaseGuard guard;
+  unsigned long MotionSwitch::*dwell; //NULL for no minimum
+};
+
 class MotionSwitch: public StateSwitch, public IMotion
 {
 public:
@@ -148,19 +207,49 @@ public:
   enum MotionStates {
     REST = 0,
     MOTION,
-    SPIN,
+    SPIN,     //Spinning without a throw (table, finger)
+    WINDUP,   //Hard linear acceleration in hand
+    RELEASE,  //Spin came up out of a windup
+    FLIGHT,
+    CATCH,
+    LANDED,
+    NUM_MOTION_STATES
   };
 
   //Make Motion States
   RestState restState;
   DynamicMotionState motionState;
   SpinState spinState;
+  WindupState windupState;
+  ReleaseState releaseState;
+  FlightState flightState;
+  CatchState catchState;
+  LandedState landedState;
 
-  int currentState = REST;
+  //Phase Table
+  //Declared once in state.cpp, grouped by from. Only the rows out of the current phase are checked, so a sample
+  //costs the features plus at most a few guard calls
+  static const PhaseTransition transitions[];
+  static const uint8_t numTransitions;
+  uint8_t rowStart[NUM_MOTION_STATES + 1]; //transitions[rowStart[s]..rowStart[s+1]) leave phase s
 
-  //Watchout! Defining This Outside of a default constructor can cause invalid pointers
-  //to be stored.
-  std::vector<MotionState*>  _states;
+  //Thresholds (Enter/Exit Pairs) & Dwell Times
+  float windupAccel = 1.5;               //g of linear acceleration that starts a windup
+  float spinHysteresis = 50;             //deg/s below spinThreshold before spin counts as gone
+  unsigned long restDebounce = 100000;   //Rest flag has to hold this long to count
+  unsigned long moveDebounce = 30000;    //& so does its absence
+  unsigned long settleDwell = 50000;     //Minimum stay in REST/MOTION/SPIN before leaving for one another
+  unsigned long windupTimeout = 1000000; //No release within this, it was just a wave
+  unsigned long releaseDwell = 20000;    //Release is a moment, then we're flying
+  unsigned long catchDwell = 300000;     //Hold catch long enough for lights & games to see it
+  unsigned long phaseSince = 0;          //micros() the current phase was entered
+
+  PhaseFeatures features( MotionEvent &motion );
+  uint8_t nextPhase( MotionEvent &motion );
+  //Phases Where The Disc Is Being Thrown Or Is In The Air
+  bool throwing() { return currentState == WINDUP || currentState == RELEASE || currentState == FLIGHT; };
+  //Phases Where Velocity Is Known To Be Zero
+  bool stationary() { return currentState == REST || currentState == LANDED; };
 
   //Important Funcitons
   virtual void initialize();
@@ -170,18 +259,18 @@ public:
 
   virtual String type() {return "MotionSwitch";};
   virtual MotionState* stateNow()
-  {
-    return _states.at(currentState);
+  { //Only MotionStates Are Added Here
+    return static_cast<MotionState*>( _states[currentState] );
   };
 
-  //Not Implemented Yet
-  virtual void update() {
-    _states[ currentState ] -> update();
-  };
-  virtual void enter() {
-    _states[ currentState ] -> enter();
-  };
-  virtual void leave() {
-    _states[ currentState ] -> leave();
-  };
+  //Rest Debounce Reads Windows Over The Motion History, Call Once The History Exists
+  void trackHistory( MotionHistory &history );
+
+private:
+  MotionHistory *_history = NULL;
+  int8_t _settleWindow = -1; //In-plane linear accel over restDebounce
+  int8_t _stirWindow = -1;   //& over moveDebounce
+  uint32_t _lastImpactCount = 0;
 };
+
+#endif
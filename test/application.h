@@ -0,0 +1,15 @@
+//Host Shim For The Firmware Headers Under Test
+//Only what the modules built by these tests pull in, the real one comes with the Particle toolchain
+#ifndef _INCL_TEST_APPLICATION
+#define _INCL_TEST_APPLICATION
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+
+unsigned long micros();
+unsigned long millis();
+
+#endif
@@ -0,0 +1,11 @@
+//Tiny Assertions For The Host Tests, Each Test Returns failures From main()
+#ifndef _INCL_TEST_CHECK
+#define _INCL_TEST_CHECK
+
+#include <stdio.h>
+
+static int failures = 0;
+
+#define CHECK(cond) do { if ( !(cond) ){ failures++; printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); } } while (0)
+
+#endif
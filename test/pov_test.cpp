@@ -0,0 +1,172 @@
+//PovRenderer Column Selection & Latching, Fed Synthetic Phases As The Loop Would
+//  g++ -I test -I . test/pov_test.cpp pov.cpp -o pov_test && ./pov_test
+#include "application.h"
+#include "pov.h"
+#include "check.h"
+
+static unsigned long now = 0;
+unsigned long micros() { return now; }
+unsigned long millis() { return now / 1000; }
+
+#define PUSH_COST 150 //Micros a frame takes to go out, charged by the fake strip
+
+static uint32_t pushes = 0;
+static uint32_t shown[POV_MAX_LEDS];
+
+static void fakeStrip(void *, const uint32_t *frame, uint8_t leds)
+{
+  memcpy( shown, frame, leds * sizeof(uint32_t) );
+  pushes++;
+  now += PUSH_COST;
+}
+
+static PovRenderer pov;
+
+//One Timer Tick At t, Only Notes The Column
+static bool tick(unsigned long t)
+{
+  now = t;
+  return pov.latch( t );
+}
+
+//A Tick, Then The Loop Gets Round To show()
+static bool step(unsigned long t)
+{
+  tick( t );
+  return pov.show( t );
+}
+
+static void columns()
+{ //Degrees To Columns, 256 A Turn
+  pov.setPhase( 0, 0, 1000 );
+  CHECK( pov.column( 1000 ) == 0 );
+  pov.setPhase( 90, 0, 1000 );
+  CHECK( pov.column( 1000 ) == 64 );
+  pov.setPhase( -90, 0, 1000 ); //Wraps Into The Turn Below
+  CHECK( pov.column( 1000 ) == 192 );
+  pov.setPhase( 720 + 45, 0, 1000 );
+  CHECK( pov.column( 1000 ) == 32 );
+
+  //Extrapolating Past A Full Turn Wraps Back Round
+  pov.setPhase( 359, 3600, 1000 );
+  CHECK( pov.column( 2000 ) == 1 ); //362.6 Degrees
+}
+
+static void negativeRate()
+{
+  pov.setPhase( 350, -3600, 0 );
+  CHECK( pov.spinning() );
+  CHECK( pov.column( 10000 ) == 223 ); //314 Degrees
+  pov.setPhase( 1, -3600, 0 );
+  CHECK( pov.column( 1000 ) == 254 ); //-2.6 Degrees, Under Zero
+
+  //Columns Count Down & Each Goes Out Once
+  pov.enabled = true;
+  pov.setPhase( 180, -3600, 0 );
+  pov.latchedColumn = 0xFFFF;
+  uint16_t last = 0xFFFF;
+  bool descending = true;
+  for (unsigned long t = 1000; t < 20000; t += 390){ //Just Under A Column At 10 Rev/s
+    if ( !tick( t ) ) continue;
+    if ( last != 0xFFFF && ( (last - pov.latchedColumn) & (POV_COLUMNS - 1) ) != 1 ) descending = false;
+    last = pov.latchedColumn;
+  }
+  CHECK( descending );
+  CHECK( last != 0xFFFF );
+}
+
+static void minRateCutoff()
+{
+  pov.enabled = true;
+  pov.minRate = 360;
+  pov.setPhase( 0, 100, 0 );
+  CHECK( !pov.running() );
+  uint32_t before = pushes;
+  CHECK( !step( 5000 ) );
+  CHECK( pushes == before );
+
+  pov.setPhase( 0, 359, 0 );
+  CHECK( !pov.spinning() );
+  pov.setPhase( 0, 361, 0 );
+  CHECK( pov.spinning() );
+  pov.setPhase( 0, -361, 0 );
+  CHECK( pov.spinning() );
+  pov.setPhase( 0, -359, 0 );
+  CHECK( !pov.spinning() );
+
+  pov.enabled = false;
+  pov.setPhase( 0, 3600, 0 );
+  CHECK( pov.spinning() && !pov.running() );
+}
+
+static void latching()
+{ //Ring Of 4 LEDs A Quarter Turn Apart, Only A Marker At Column 0
+  pov.ringLayout( 4 );
+  pov.clear( 0 );
+  pov.palette[1] = 0xFF0000;
+  pov.set( 0, 0, 1 );
+  pov.enabled = true;
+
+  unsigned long t = 100000;
+  pov.setPhase( 0, 360, t );
+  //The Interrupt Never Touches The Strip
+  uint32_t before = pushes;
+  CHECK( tick( t ) );
+  CHECK( pushes == before );
+  CHECK( pov.show( t ) );
+  CHECK( shown[0] == 0xFF0000 && shown[1] == 0 && shown[2] == 0 && shown[3] == 0 );
+  //Same Column, Nothing New To Show
+  before = pushes;
+  CHECK( !step( t + 500 ) );
+  CHECK( pushes == before );
+
+  //A Quarter Turn On, The LED Three Quarters Round The Disc Is Over The Marker
+  CHECK( step( t + 250100 ) ); //Clear Of The Boundary, Rate Is Truncated To Whole Units
+  CHECK( pov.latchedColumn == 64 );
+  CHECK( shown[0] == 0 && shown[3] == 0xFF0000 );
+
+  //Spin Drops Out, The Strip Goes Dark Once & Stays Left Alone
+  t += 300000;
+  pov.setPhase( 0, 100, t );
+  before = pushes;
+  CHECK( !step( t ) );
+  CHECK( pushes == before + 1 && shown[3] == 0 );
+  CHECK( !step( t + 1000 ) );
+  CHECK( pushes == before + 1 );
+}
+
+static void rateCap()
+{ //30 Rev/s Is A Column Every 130us, Far Faster Than A Quarter Of The Loop Can Push
+  pov.ringLayout( 50 );
+  pov.enabled = true;
+  pov.maxShare = 25;
+  const unsigned long interval = PUSH_COST * 100 / 25;
+  unsigned long t = 1000000;
+  pov.setPhase( 0, 10800, t );
+  CHECK( step( t ) );
+  unsigned long lastPush = t;
+  unsigned long closest = 0xFFFFFFFF;
+  uint32_t latched = 0;
+  for (t += 50; t < 1100000; t += 50){ //Timer Ticks Every 50us
+    if ( !step( t ) ) continue;
+    latched++;
+    if ( t - lastPush < closest ) closest = t - lastPush;
+    lastPush = t;
+  }
+  CHECK( pov.pushMicros == PUSH_COST );
+  CHECK( closest == interval );
+  CHECK( latched == (uint32_t)( (100000 - 1) / interval ) );
+}
+
+int main()
+{
+  pov.push = &fakeStrip;
+  columns();
+  negativeRate();
+  minRateCutoff();
+  latching();
+  rateCap();
+
+  printf( failures ? "pov_test: %d failed\n" : "pov_test: ok\n", failures );
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,102 @@
+//Session On A LoopbackHub: Discovery, Leader Election, Clock Sync, Expiry & Hand Over
+//  g++ -I test -I . test/session_test.cpp session.cpp -o session_test && ./session_test
+#include "application.h"
+#include "session.h"
+#include "check.h"
+
+unsigned long micros() { return 0; } //Session only reads its transport's clock
+unsigned long millis() { return 0; }
+
+#define DISCS 4
+#define TICK 1000       //One frame, micros
+#define SLACK TICK      //Loopback delivery is quantized to frames
+
+static LoopbackHub hub;
+static LoopbackTransport links[DISCS + 1] = {
+  LoopbackTransport( hub, 123456 ), LoopbackTransport( hub, -98765 ), LoopbackTransport( hub, 7777777 ),
+  LoopbackTransport( hub, 31 ), LoopbackTransport( hub, -4000000 )
+};
+static Session discs[DISCS + 1];
+static bool running[DISCS + 1];
+
+static void run(unsigned long micros)
+{
+  for (unsigned long t = 0; t < micros; t += TICK){
+    hub.now += TICK;
+    for (int i = 0; i <= DISCS; i++){ if ( running[i] ) discs[i].update(); }
+  }
+}
+
+static long skew(Session &a, Session &b)
+{
+  return (long)( a.clock() - b.clock() );
+}
+
+static void checkSynced(int leader)
+{
+  for (int i = 0; i <= DISCS; i++){
+    if ( !running[i] ) continue;
+    CHECK( discs[i].leader() == discs[leader].disc );
+    CHECK( discs[i].synced() );
+    if ( i == leader ) continue;
+    long error = labs( skew( discs[i], discs[leader] ) );
+    CHECK( discs[i].syncRtt != NO_RTT );
+    CHECK( error <= (long)( discs[i].syncRtt / 2 ) + SLACK );
+  }
+}
+
+int main()
+{
+  //Discs 2..5, Started Out Of Order
+  const uint8_t ids[DISCS] = { 4, 2, 5, 3 };
+  for (int i = 0; i < DISCS; i++){
+    discs[i].begin( &links[i], ids[i] );
+    running[i] = true;
+  }
+
+  //Nobody Has A Clock Yet, The Lowest Starts One Once It Has Listened
+  run( 500000 );
+  for (int i = 0; i < DISCS; i++){
+    CHECK( discs[i].numPeers == DISCS - 1 );
+    CHECK( discs[i].leader() == 2 );
+    CHECK( !discs[i].synced() );
+  }
+  run( 2000000 );
+  checkSynced( 1 );
+
+  //Leader Goes Quiet, It Expires Everywhere & The Next Lowest With The Clock Takes Over Without A Jump
+  unsigned long before = discs[3].clock();
+  running[1] = false;
+  run( discs[0].peerTimeout + 2 * discs[0].heartbeat );
+  CHECK( (long)( discs[3].clock() - before - ( discs[0].peerTimeout + 2 * discs[0].heartbeat ) ) == 0 );
+  for (int i = 0; i < DISCS; i++){
+    if ( !running[i] ) continue;
+    CHECK( discs[i].numPeers == DISCS - 2 );
+    CHECK( discs[i].peer( 2 ) == NULL );
+  }
+  run( 2000000 );
+  checkSynced( 3 );
+
+  //A Lower Id Joins With Its Own Clock, It Follows The Session Until It Has Synced & Only Then Leads
+  long drift[DISCS];
+  for (int i = 0; i < DISCS; i++){ drift[i] = running[i] ? skew( discs[i], discs[3] ) : 0; }
+  before = discs[3].clock();
+  unsigned long start = hub.now;
+  discs[DISCS].begin( &links[DISCS], 1 );
+  running[DISCS] = true;
+  while ( !discs[DISCS].hasClock && hub.now < 60000000 ){
+    for (int i = 0; i < DISCS; i++){ if ( running[i] ) CHECK( discs[i].leader() == 3 ); }
+    run( TICK );
+  }
+  CHECK( discs[DISCS].hasClock );
+  CHECK( labs( skew( discs[DISCS], discs[3] ) ) <= (long)( discs[DISCS].syncRtt / 2 ) + SLACK );
+  run( 2000000 );
+  checkSynced( DISCS );
+  CHECK( labs( (long)( discs[3].clock() - before - ( hub.now - start ) ) ) <= (long)( discs[3].syncRtt / 2 ) + SLACK );
+  for (int i = 0; i < DISCS; i++){ //Old Followers Stay Where They Were
+    if ( running[i] ) CHECK( labs( skew( discs[i], discs[3] ) - drift[i] ) <= 2 * SLACK + (long)discs[i].syncRtt );
+  }
+
+  printf( failures ? "session_test: %d failed\n" : "session_test: ok\n", failures );
+  return failures ? 1 : 0;
+}
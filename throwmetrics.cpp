@@ -0,0 +1,140 @@
+#include "throwmetrics.h"
+#import "globals.h"
+
+//Landing Is Found Inside A Phase Transition, The Report Goes Out After The Physics Step
+static void reportThrow(void *target, void *payload)
+{
+  ThrowRecord &record = static_cast<ThrowMetrics*>(target) -> lastThrow;
+  frisbeem._com.send_throw( record );
+  frisbeem._session.sendEvent( SESSION_THROW, record.number, constrain( record.peakHeight * 100, 0.0f, 65535.0f ) ); //cm
+}
+
+//Same Number Again, Now From The Drift Corrected Segment
+static void reportRevision(void *target, void *payload)
+{
+  frisbeem._com.send_throw( static_cast<ThrowMetrics*>(target) -> lastThrow );
+}
+
+void ThrowMetrics::onTransition(TransitionEvent &transition)
+{
+  if ( transition.to == MotionSwitch::RELEASE && !inFlight ){ release(); }
+  else if ( transition.from == MotionSwitch::FLIGHT && inFlight ){ land(); }
+}
+
+void ThrowMetrics::release()
+{
+  if ( _heightPending ){ publish(); } //Next Throw Already, Go With The Peak So Far
+  inFlight = true;
+  _heightStarted = false;
+  _revisable = false;
+  _revised = false;
+  _releasePending = true;
+}
+
+void ThrowMetrics::update(MotionEvent &motion, Quaternion &q)
+{
+  if ( !inFlight ) return;
+
+  if ( _releasePending )
+  { //Snapshot Of The Disc As It Leaves The Hand
+    _releasePending = false;
+    _releaseTime = motion.t;
+    _releaseX = motion.X;
+    _zuptUpdates = frisbeem._mpu.zupt.updates;
+    _releaseSeg = frisbeem._mpu.zupt.elapsed();
+    _current.releaseSpeed = motion.V.getMagnitude();
+    _current.releaseRpm = fabs(motion.G.z) / 6.0f; //deg/s -> rev/min
+
+    //Disc Normal In The World vs The Direction Of Travel
+    VectorFloat normal(0, 0, 1);
+    normal.rotate( &q );
+    float vh = sqrt(motion.V.x * motion.V.x + motion.V.y * motion.V.y);
+    if ( vh > 0.1f ){
+      //Left Of Travel Is Up x Direction
+      float lx = -motion.V.y / vh, ly = motion.V.x / vh;
+      _current.hyzer = atan2(normal.x * lx + normal.y * ly, normal.z) * 180.0f / M_PI;
+    }
+    else{ //No Direction To Judge Against, Report Plain Tilt
+      _current.hyzer = acos( constrain(normal.z, -1.0f, 1.0f) ) * 180.0f / M_PI;
+    }
+  }
+
+  _lastX = motion.X;
+  _lastTime = motion.t;
+}
+
+void ThrowMetrics::height(float z, unsigned long t)
+{
+  _heightTime = t;
+  if ( !inFlight && !_heightPending ) return;
+  if ( _releasePending || (long)(t - _releaseTime) < 0 ) return; //Still From Before The Release
+
+  if ( _heightPending && (long)(t - _lastTime) > 0 ){ publish(); return; }
+  if ( !_heightStarted ){ _heightStarted = true; _releaseZ = z; _maxZ = z; }
+  else if ( z > _maxZ ){ _maxZ = z; }
+}
+
+void ThrowMetrics::land()
+{
+  inFlight = false;
+  if ( _releasePending ){ _releasePending = false; return; } //Never Saw A Sample
+
+  float flightTime = (_lastTime - _releaseTime) / 1000000.0f;
+  if ( flightTime < minFlightTime ) return;
+
+  _current.flightTime = flightTime;
+  float dx = _lastX.x - _releaseX.x, dy = _lastX.y - _releaseX.y;
+  _current.distance = sqrt(dx * dx + dy * dy);
+
+  //Revisable Once The Segment We Flew In Closes
+  ZuptIntegrator &zupt = frisbeem._mpu.zupt;
+  _landSeg = zupt.elapsed();
+  _revisable = zupt.updates == _zuptUpdates && _landSeg > _releaseSeg;
+
+  //Heights Behind The Landing Still Have Some Of The Flight To Come
+  _heightPending = (long)(_heightTime - _lastTime) < 0;
+  if ( !_heightPending ){ publish(); }
+}
+
+void ThrowMetrics::publish()
+{
+  _heightPending = false;
+  if ( !_revised ){ _current.peakHeight = _heightStarted ? _maxZ - _releaseZ : 0; }
+  _current.number = ++throwCount;
+  lastThrow = _current;
+
+  frisbeem._deferred.post( PRIORITY_REPORT, &reportThrow, this );
+}
+
+void ThrowMetrics::revise(ZuptIntegrator &zupt)
+{ //Only The Update That Closes The Throw's Own Segment
+  if ( !_revisable ) return;
+  _revisable = false;
+  if ( zupt.updates != _zuptUpdates + 1 ) return;
+
+  //Release Has To Still Be In The Window
+  ZuptIntegrator::Sample s, release, landing;
+  if ( !zupt.sample( zupt.size() - 1, s ) || s.t > _releaseSeg + zupt.sampleInterval ) return;
+
+  bool started = false;
+  float maxZ = 0;
+  for (int age = zupt.size() - 1; age >= 0; age--)
+  { //Oldest First, Release To Landing
+    zupt.sample( age, s );
+    if ( s.t < _releaseSeg ) continue;
+    if ( s.t > _landSeg ) break;
+    if ( !started ){ started = true; release = s; maxZ = s.X.z; }
+    if ( s.X.z > maxZ ){ maxZ = s.X.z; }
+    landing = s;
+  }
+  if ( !started ) return;
+
+  _current.peakHeight = maxZ - release.X.z;
+  float dx = landing.X.x - release.X.x, dy = landing.X.y - release.X.y;
+  _current.distance = sqrt(dx * dx + dy * dy);
+  _revised = true;
+  if ( _heightPending ) return; //Not Out Yet, publish() Takes It As Is
+
+  lastThrow = _current;
+  frisbeem._deferred.post( PRIORITY_REPORT, &reportRevision, this );
+}
@@ -0,0 +1,68 @@
+#include "application.h"
+
+#ifndef _INCL_THROWMETRICS
+#define _INCL_THROWMETRICS
+
+#include "3dmath.h"
+
+class MotionEvent;
+class ZuptIntegrator;
+class TransitionEvent;
+
+//One Summary Per Throw
+struct ThrowRecord {
+  uint16_t number;
+  float releaseSpeed;   //m/s, |V| at release
+  float releaseRpm;     //Spin at release
+  float hyzer;          //deg, tilt across the flight path. + is hyzer for a right hand backhand (left edge down)
+  float flightTime;     //s
+  float peakHeight;     //m above the release point
+  float distance;       //m, horizontal from release to end of flight
+};
+
+//Throw Metrics Engine
+//Driven by MotionSwitch transitions: entering RELEASE starts a throw, leaving FLIGHT ends it.
+//Everything is accumulated sample by sample during flight, so ending a throw is O(1) and publishes one record.
+//Heights come in through height() & may lag the samples (the smoothed track), the record waits until they catch up.
+//When the disc comes to rest the zero velocity update corrects the whole segment, revise() redoes peak & distance
+//from it & the record goes out again with the same number
+class ThrowMetrics
+{
+public:
+  //Parameters
+  float minFlightTime = 0.1; //s, shorter spins (flicks on a table) don't count
+
+  //Output
+  ThrowRecord lastThrow;
+  uint16_t throwCount = 0;
+  bool inFlight = false;
+
+  void onTransition(TransitionEvent &transition); //Off The Bus
+  void update(MotionEvent &motion, Quaternion &q);
+  void height(float z, unsigned long t);
+  void revise(ZuptIntegrator &zupt);
+
+private:
+  void release();
+  void land();
+  void publish();
+
+  ThrowRecord _current;
+  unsigned long _releaseTime;
+  unsigned long _lastTime;
+  VectorFloat _releaseX;
+  VectorFloat _lastX;
+  float _releaseZ, _maxZ;
+  unsigned long _heightTime = 0; //Newest height seen
+  bool _heightStarted = false;
+  bool _releasePending = false; //Take the release snapshot from the next sample
+  bool _heightPending = false;  //Landed, waiting for the heights to get past it
+
+  //Where The Throw Sits In The Integrator's Motion Segment
+  uint32_t _zuptUpdates;        //Count before the release, the next update closes our segment
+  float _releaseSeg, _landSeg;  //s into the segment
+  bool _revisable = false;
+  bool _revised = false;        //Peak & distance already came from the corrected segment
+};
+
+#endif
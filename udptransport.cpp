@@ -0,0 +1,33 @@
+#include "udptransport.h"
+
+bool UDPTransport::begin()
+{
+  if ( _open ) end();
+  if ( _udp.begin( SESSION_PORT ) == 0 ) return false;
+  _udp.joinMulticast( SESSION_GROUP );
+  _open = true;
+  return true;
+}
+
+void UDPTransport::end()
+{
+  if ( !_open ) return;
+  _udp.leaveMulticast( SESSION_GROUP );
+  _udp.stop();
+  _open = false;
+}
+
+bool UDPTransport::send(const uint8_t *data, size_t size)
+{
+  if ( !_open ) return false;
+  return _udp.sendPacket( data, size, SESSION_GROUP, SESSION_PORT ) >= 0;
+}
+
+int UDPTransport::receive(uint8_t *data, size_t size)
+{
+  if ( !_open ) return 0;
+  int length = _udp.parsePacket();
+  if ( length <= 0 ) return 0;
+  if ( (size_t)length > size ){ _udp.flush(); return 0; } //Not One Of Ours
+  return _udp.read( data, length );
+}
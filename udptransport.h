@@ -0,0 +1,25 @@
+#include "application.h"
+
+#ifndef _INCL_UDPTRANSPORT
+#define _INCL_UDPTRANSPORT
+
+#include "session.h"
+
+#define SESSION_PORT 18331
+#define SESSION_GROUP IPAddress(239,1,83,31) //Administratively scoped, stays on the LAN
+
+//UDP Multicast On SESSION_GROUP
+class UDPTransport: public SessionTransport
+{
+public:
+  virtual bool begin();
+  virtual void end();
+  virtual bool send(const uint8_t *data, size_t size);
+  virtual int receive(uint8_t *data, size_t size);
+
+private:
+  UDP _udp;
+  bool _open = false;
+};
+
+#endif
@@ -0,0 +1,103 @@
+#include "zupt.h"
+
+void ZuptIntegrator::update(VectorFloat &Awrld, float dt, bool still)
+{
+  if ( still ){ _stillCount++; }
+  else { _stillCount = 0; }
+
+  //Stopped Long Enough, Take The Drift Out Of The Segment
+  if ( _moving && _stillCount >= restSamplesForUpdate ){
+    applyZeroVelocityUpdate();
+    _moving = false;
+  }
+
+  if ( !_moving ){
+    if ( still ){ //Hold Position, Velocity Is Zero By Definition
+      _Alast = Awrld;
+      return;
+    }
+    //Starting A New Segment
+    _moving = true;
+    _segmentTime = 0;
+    _count = 0;
+    push();
+  }
+
+  //Trapezoidal Double Integration
+  float h = dt / 2.0;
+  float h_mps = h * gravity;
+  VectorFloat Vlast = V;
+  V.x += ( Awrld.x + _Alast.x ) * h_mps;
+  V.y += ( Awrld.y + _Alast.y ) * h_mps;
+  V.z += ( Awrld.z + _Alast.z ) * h_mps;
+  X.x += ( V.x + Vlast.x ) * h;
+  X.y += ( V.y + Vlast.y ) * h;
+  X.z += ( V.z + Vlast.z ) * h;
+  _segmentTime += dt;
+  _Alast = Awrld;
+  if ( _segmentTime - _lastPush >= sampleInterval ){ push(); }
+}
+
+void ZuptIntegrator::reset(VectorFloat &pos)
+{
+  V = VectorFloat();
+  X = pos;
+  _Alast = VectorFloat();
+  _moving = false;
+  _stillCount = 0;
+  _count = 0;
+}
+
+bool ZuptIntegrator::sample(int age, Sample &out)
+{
+  if ( age < 0 || age >= _count ) return false;
+  int inx = _head - 1 - age;
+  if ( inx < 0 ) inx += ZUPT_WINDOW;
+  out = _window[inx];
+  return true;
+}
+
+void ZuptIntegrator::push()
+{
+  Sample &s = _window[_head];
+  s.t = _segmentTime;
+  s.V = V;
+  s.X = X;
+  _lastPush = _segmentTime;
+  _head = (_head + 1) % ZUPT_WINDOW;
+  if ( _count < ZUPT_WINDOW ) _count++;
+}
+
+void ZuptIntegrator::applyZeroVelocityUpdate()
+{
+  float T = _segmentTime;
+  lastResidual = V;
+  lastSegmentTime = T;
+  updates++;
+  if ( T <= 0 ){
+    V = VectorFloat();
+    return;
+  }
+
+  //Linear Drift: dV(t) = r t/T, Integrated: dX(t) = r t^2/2T
+  float kv = 1.0f / T;
+  float kx = 0.5f / T;
+  for (int age = 0; age < _count; age++){
+    int inx = _head - 1 - age;
+    if ( inx < 0 ) inx += ZUPT_WINDOW;
+    Sample &s = _window[inx];
+    float fv = s.t * kv;
+    float fx = s.t * s.t * kx;
+    s.V.x -= lastResidual.x * fv; s.V.y -= lastResidual.y * fv; s.V.z -= lastResidual.z * fv;
+    s.X.x -= lastResidual.x * fx; s.X.y -= lastResidual.y * fx; s.X.z -= lastResidual.z * fx;
+  }
+
+  //Samples That Fell Out Of The Window Don't Matter For The End Point, It's Closed Form
+  V = VectorFloat();
+  X.x -= lastResidual.x * T * 0.5f;
+  X.y -= lastResidual.y * T * 0.5f;
+  X.z -= lastResidual.z * T * 0.5f;
+
+  //Segment Still Holds Its Corrected Trajectory
+  if ( onUpdate != NULL ){ onUpdate( updateTarget, *this ); }
+}
@@ -0,0 +1,63 @@
+#include "application.h"
+
+#ifndef _INCL_ZUPT
+#define _INCL_ZUPT
+
+#include "3dmath.h"
+
+#define ZUPT_WINDOW 256 //Samples Of Trajectory Kept For Retroactive Correction, One Per sampleInterval
+
+//Zero Velocity Update Integrator
+//Double integrates world acceleration while moving. When the disc comes to rest the velocity should be
+//zero, so whatever is left over is drift. We assume it built up linearly over the motion segment and remove
+//it from every sample still in the window (and analytically from the final position), instead of snapping V to 0.
+//Each sample is corrected at most once, so the cost is O(1) amortized per sample. The corrected segment is handed
+//to onUpdate, ThrowMetrics revises the throw from it.
+class ZuptIntegrator
+{
+public:
+  ZuptIntegrator(): X(0, 0, 1) {}; //Start 1m Off The Ground (Hand Height)
+
+  struct Sample {
+    float t; //Seconds since the motion segment began
+    VectorFloat V, X;
+  };
+
+  //Parameters
+  int restSamplesForUpdate = 10; //Consecutive still samples before a zero velocity update
+  float sampleInterval = 0.02;   //s between stored samples, the window covers ~5s of motion
+  float gravity = 9.81;          //Awrld is in g's
+
+  //Outputs
+  VectorFloat V, X;
+  VectorFloat lastResidual;      //Velocity drift removed by the last update
+  float lastSegmentTime = 0;     //Length of the last corrected segment (s)
+  uint32_t updates = 0;
+  float elapsed() { return _moving ? _segmentTime : 0; }; //Into the current motion segment (s), 0 at rest
+
+  //Called Once The Segment Has Been Corrected, From Inside update()
+  void (*onUpdate)(void *target, ZuptIntegrator &zupt) = NULL;
+  void *updateTarget = NULL;
+
+  void update(VectorFloat &Awrld, float dt, bool still);
+  void reset(VectorFloat &pos);
+
+  //Trajectory Of The Current/Last Segment, age 0 Is Newest
+  int size() { return _count; };
+  bool sample(int age, Sample &out);
+
+private:
+  void push();
+  void applyZeroVelocityUpdate();
+
+  Sample _window[ZUPT_WINDOW];
+  int _head = 0;  //Next write slot
+  int _count = 0;
+  float _segmentTime = 0;
+  float _lastPush = 0;
+  int _stillCount = 0;
+  bool _moving = false;
+  VectorFloat _Alast;
+};
+
+#endif